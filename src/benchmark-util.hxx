@@ -0,0 +1,12 @@
+// this file contains the helpers every *_benchmark.cxx program shares; the graphs they run on come from workload-generators.hxx
+
+#ifndef __BENCHMARK_UTIL_HXX__
+#define __BENCHMARK_UTIL_HXX__
+
+#include <chrono>
+
+double seconds_since(std::chrono::steady_clock::time_point start) { // wall-clock seconds since start, on the clock every benchmark times with
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif
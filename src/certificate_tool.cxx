@@ -0,0 +1,58 @@
+// this writes the certificates for a graph out to a compact binary file, or verifies such a file against a graph later (possibly on another machine)
+// usage: certificate_tool write <graph file> <certificate file>
+//        certificate_tool verify <graph file> <certificate file>
+
+#include "gsp-sp-op.hxx"
+#include "gsp-sp-op-serialization.hxx"
+#include "graph-normalization.hxx"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char ** argv) {
+	if (argc != 4 || (std::string{argv[1]} != "write" && std::string{argv[1]} != "verify")) {
+		std::cerr << "usage: " << argv[0] << " write|verify <graph file> <certificate file>\n";
+		return 2;
+	}
+
+	std::string mode = argv[1];
+	std::ifstream fin{argv[2]};
+	graph g;
+	fin >> g;
+	if (!fin) {
+		std::cerr << "failed to read graph from " << argv[2] << "\n";
+		return 2;
+	}
+
+	normalization_report normalized = normalize_graph(g); // both modes normalize the same way, so certificates written for a graph with parallel edges still verify against it
+	if (!normalized.simple()) {
+		std::cerr << "normalized " << argv[2] << ": ";
+		normalized.print(std::cerr);
+	}
+	if (!normalized.connected()) {
+		std::cerr << argv[2] << " is not connected (" << normalized.components << " components)\n";
+		return 2;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	if (mode == "write") {
+		gsp_sp_op_result r = GSP_SP_OP(g);
+		if (!write_result_file(argv[3], r)) {
+			std::cerr << "failed to write certificates to " << argv[3] << "\n";
+			return 1;
+		}
+
+		std::cout << "graph is " << (r.is_gsp ? "" : "NOT ") << "GSP, " << (r.is_sp ? "" : "NOT ") << "SP, and " << (r.is_op ? "" : "NOT ") << "OP\n";
+	} else {
+		if (!verify_result_file(argv[3], g)) {
+			std::cout << "certificates in " << argv[3] << " do NOT authenticate against " << argv[2] << "\n";
+			return 1;
+		}
+
+		std::cout << "certificates in " << argv[3] << " authenticate against " << argv[2] << "\n";
+	}
+
+	std::cout << mode << " took " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << "s\n";
+	return 0;
+}
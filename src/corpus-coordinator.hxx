@@ -0,0 +1,511 @@
+// this file contains a coordinator that shards a corpus across worker processes on the local machine, so a corpus of tens of millions of graphs can use every core and an input that crashes the implementation only takes its own worker down
+// every worker is forked from the coordinator and runs the same load/classify/authenticate steps as the corpus pipeline on one file at a time, talking to the coordinator over a pair of pipes only (so the same protocol could run over sockets between machines later)
+// the corpus is either a directory of graph files or a pack file, which holds many graphs in one file so a huge corpus doesn't need millions of files
+//
+// a pack file is the 4 bytes "GSPK" and a version byte (currently 1), followed by one record per graph until the end of the file: the length of its name, the name, the length of its text and the text (in the usual input format), with every length an unsigned LEB128 varint
+// the coordinator sends a worker a shard as two 8 byte integers, the first index in it and the index after the last; the worker sends back one frame per item in order, its length as a varint followed by
+// the index, a flags byte (bit 0 loaded, bit 1 authenticated, bits 2 to 4 is_gsp, is_sp and is_op), n, e, the error, the classify callback's report and the serialized result (empty unless asked for), each string as its length followed by its bytes
+// a worker that dies is blamed for the first item of its shard it hadn't sent back, which is recorded as a failure, and the rest of its shard goes back to the front of the queue for a new worker
+
+#ifndef __CORPUS_COORDINATOR_HXX__
+#define __CORPUS_COORDINATOR_HXX__
+
+#include "corpus-pipeline.hxx"
+#include "gsp-sp-op-serialization.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ---------------- corpus sources ----------------
+
+struct corpus_source { // the graphs of a corpus, either the files of a directory or the records of a memory-mapped pack file
+					   // it's opened before the workers are forked, so they all share the file list or the mapping without copying it
+	std::vector<std::filesystem::path> files;
+	std::vector<std::string> names;							// (pack) the name of every record
+	std::vector<std::pair<size_t, size_t>> texts;			// (pack) the offset and length of the text of every record
+	unsigned char const * pack = nullptr;
+	size_t pack_size = 0;
+
+	corpus_source() {}
+	corpus_source(corpus_source const&) = delete;
+	corpus_source& operator=(corpus_source const&) = delete;
+	~corpus_source() {
+		if (pack) munmap((void *)(pack), pack_size);
+	}
+
+	size_t size() const {return pack ? names.size() : files.size();}
+
+	std::string name(size_t i) const {return pack ? names[i] : files[i].filename().string();}
+
+	bool text(size_t i, std::string& out) const { // the text of graph i, which can only fail to be read from a directory
+		if (pack) {
+			out.assign((char const *)(pack) + texts[i].first, texts[i].second);
+			return true;
+		}
+
+		std::ifstream fin{files[i], std::ios::binary};
+		if (!fin) return false;
+		std::ostringstream contents;
+		contents << fin.rdbuf();
+		out = std::move(contents).str();
+		return true;
+	}
+};
+
+bool open_corpus_pack(std::filesystem::path const& path, corpus_source& source) { // map a pack file and index its records, failing if it's truncated or isn't a pack
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < 5) {
+		close(fd);
+		return false;
+	}
+
+	void * map = mmap(nullptr, (size_t)(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return false;
+	source.pack = (unsigned char const *)(map);
+	source.pack_size = (size_t)(st.st_size);
+
+	cert_reader in{source.pack, source.pack_size};
+	if (std::memcmp(source.pack, "GSPK", 4) != 0 || source.pack[4] != 1) return false;
+	in.pos += 5;
+
+	while (in.ok && in.remaining() > 0) {
+		size_t name_length = in.count(in.remaining());
+		source.names.emplace_back((char const *)(in.pos), name_length);
+		in.pos += name_length;
+		size_t text_length = in.count(in.remaining());
+		source.texts.emplace_back((size_t)(in.pos - source.pack), text_length);
+		in.pos += text_length;
+	}
+
+	return in.ok;
+}
+
+bool open_corpus(std::filesystem::path const& path, corpus_source& source) { // a directory (its .txt files, see list_corpus_files) or a pack file
+	std::error_code ec;
+	if (std::filesystem::is_directory(path, ec)) {
+		source.files = list_corpus_files(path);
+		return true;
+	}
+	return open_corpus_pack(path, source);
+}
+
+bool write_corpus_pack(corpus_source const& source, std::filesystem::path const& path) { // pack every graph of a corpus into one file, in corpus order
+	std::ofstream out{path, std::ios::binary};
+	out.write("GSPK\1", 5);
+
+	std::string text;
+	cert_writer header;
+	for (size_t i = 0; i < source.size() && out; i++) {
+		if (!source.text(i, text)) return false;
+		std::string name = source.name(i);
+		header.bytes.clear();
+		header.varint(name.size());
+		out.write((char const *)(header.bytes.data()), (std::streamsize)(header.bytes.size()));
+		out.write(name.data(), (std::streamsize)(name.size()));
+		header.bytes.clear();
+		header.varint(text.size());
+		out.write((char const *)(header.bytes.data()), (std::streamsize)(header.bytes.size()));
+		out.write(text.data(), (std::streamsize)(text.size()));
+	}
+
+	return (bool)(out.flush());
+}
+
+// ---------------- coordinator ----------------
+
+struct corpus_result { // what a worker sends back for one graph
+	size_t index = 0;
+	std::string name;
+	bool loaded = false;
+	bool authenticated = false;
+	bool is_gsp = false;
+	bool is_sp = false;
+	bool is_op = false;
+	int n = 0;
+	int e = 0;
+	std::string error;							// set if the graph couldn't be loaded, classifying it threw, or its worker crashed on it
+	std::string report;							// the classify callback's report
+	std::vector<unsigned char> certificates;	// the serialized result (see gsp-sp-op-serialization.hxx), if corpus_cluster_config::certificates is set
+
+	bool failed() const {return !error.empty() || !authenticated;}
+};
+
+struct corpus_cluster_config {
+	int workers = 0;				// 0 means one per hardware thread
+	size_t shard_size = 64;			// the number of graphs a worker is sent at a time
+	size_t window = 0;				// maximum number of shards between the oldest one not yet emitted and the newest one sent, which bounds the reorder buffer; 0 means 4 per worker
+	double item_timeout = 0;		// seconds a worker may spend on one graph before it's killed and the graph recorded as a failure; 0 means no limit
+	bool certificates = false;		// send the serialized result of every graph back too
+};
+
+struct corpus_worker_report {
+	long items = 0;		// graphs sent back by the workers in this slot
+	long shards = 0;	// shards sent to them
+	long crashes = 0;	// workers in this slot that died (and were replaced)
+};
+
+struct corpus_failure {
+	size_t index;
+	std::string name;
+	std::string error;
+};
+
+struct corpus_cluster_report {
+	double wall_seconds = 0;
+	long items = 0;
+	long loaded = 0;
+	long authenticated = 0;
+	long gsp = 0;
+	long sp = 0;
+	long op = 0;
+	long shards = 0;
+	long reassigned = 0;						// shards made of what was left of the shard of a worker that died
+	std::vector<corpus_worker_report> workers;
+	std::vector<corpus_failure> failures;		// every graph that didn't load or authenticate, in corpus order
+
+	void print(std::ostream& os) const {
+		os << items << " graphs in " << std::fixed << std::setprecision(3) << wall_seconds << "s: " << loaded << " loaded, " << authenticated << " authenticated, "
+		   << gsp << " GSP, " << sp << " SP, " << op << " OP, " << failures.size() << (failures.size() == 1 ? " failure\n" : " failures\n");
+		os << "  " << shards << " shards (" << reassigned << " reassigned after a crash) on " << workers.size() << (workers.size() == 1 ? " worker\n" : " workers\n");
+		for (size_t w = 0; w < workers.size(); w++) {
+			os << "  worker " << std::setw(3) << w << ": " << std::setw(8) << workers[w].items << " graphs, " << std::setw(6) << workers[w].shards << " shards, " << workers[w].crashes << (workers[w].crashes == 1 ? " crash\n" : " crashes\n");
+		}
+		os << std::defaultfloat;
+	}
+};
+
+bool write_fully(int fd, void const * data, size_t size) { // write all of data to a pipe, however many writes it takes
+	char const * pos = (char const *)(data);
+	while (size > 0) {
+		ssize_t written = write(fd, pos, size);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0) return false;
+		pos += written;
+		size -= (size_t)(written);
+	}
+	return true;
+}
+
+bool read_fully(int fd, void * data, size_t size) { // read exactly size bytes from a pipe, failing at the end of it
+	char * pos = (char *)(data);
+	while (size > 0) {
+		ssize_t got = read(fd, pos, size);
+		if (got < 0 && errno == EINTR) continue;
+		if (got <= 0) return false;
+		pos += got;
+		size -= (size_t)(got);
+	}
+	return true;
+}
+
+void corpus_worker(corpus_source const& source, int tasks, int results, bool certificates, std::function<void(corpus_item&)> const& classify) { // the body of a worker process: classify every shard it's sent until its task pipe is closed
+	uint64_t shard[2];
+	std::string text;
+	cert_writer frame, body;
+
+	while (read_fully(tasks, shard, sizeof(shard))) {
+		for (uint64_t i = shard[0]; i < shard[1]; i++) {
+			corpus_item item;
+			item.index = (size_t)(i);
+			item.path = source.name(item.index);
+			if (!source.text(item.index, item.text)) {
+				item.error = "cannot open file";
+			} else {
+				load_corpus_item(item);
+				if (item.loaded) classify_corpus_item(item, classify);
+			}
+
+			std::vector<unsigned char> bytes;
+			if (certificates && item.loaded && item.error.empty()) serialize_result(item.result, bytes);
+
+			body.bytes.clear();
+			body.varint(i);
+			body.byte((unsigned char)(item.loaded | item.authenticated << 1 | item.result.is_gsp << 2 | item.result.is_sp << 3 | item.result.is_op << 4));
+			body.varint((uint64_t)(item.loaded ? item.g.n : 0));
+			body.varint((uint64_t)(item.loaded ? item.g.e : 0));
+			for (std::string const* s : {&item.error, &item.report}) {
+				body.varint(s->size());
+				body.bytes.insert(body.bytes.end(), s->begin(), s->end());
+			}
+			body.varint(bytes.size());
+			body.bytes.insert(body.bytes.end(), bytes.begin(), bytes.end());
+
+			frame.bytes.clear();
+			frame.varint(body.bytes.size());
+			if (!write_fully(results, frame.bytes.data(), frame.bytes.size()) || !write_fully(results, body.bytes.data(), body.bytes.size())) return; // the coordinator is gone
+		}
+	}
+}
+
+bool read_corpus_result(unsigned char const * data, size_t size, corpus_result& r) { // decode the body of a frame
+	cert_reader in{data, size};
+	r.index = (size_t)(in.varint());
+	unsigned char flags = in.byte();
+	r.loaded = flags & 1;
+	r.authenticated = flags & 2;
+	r.is_gsp = flags & 4;
+	r.is_sp = flags & 8;
+	r.is_op = flags & 16;
+	r.n = (int)(in.varint());
+	r.e = (int)(in.varint());
+	for (std::string * s : {&r.error, &r.report}) {
+		size_t length = in.count(in.remaining());
+		s->assign((char const *)(in.pos), length);
+		in.pos += length;
+	}
+	size_t length = in.count(in.remaining());
+	r.certificates.assign(in.pos, in.pos + length);
+	in.pos += length;
+	return in.ok && in.remaining() == 0;
+}
+
+corpus_cluster_report run_corpus_cluster(corpus_source const& source,
+										 corpus_cluster_config config,
+										 std::function<void(corpus_item&)> const& classify,	 // extra per-graph work done in the workers after GSP_SP_OP and authentication, which can leave text in item.report to send back (may be empty)
+										 std::function<void(corpus_result&)> const& emit) {	 // called in the coordinator, once per graph, in corpus order
+	using clock = std::chrono::steady_clock;
+
+	if (config.workers <= 0) config.workers = std::max(1, (int)(std::thread::hardware_concurrency()));
+	if (config.shard_size == 0) config.shard_size = 1;
+	if (config.window == 0) config.window = 4 * (size_t)(config.workers);
+
+	struct worker_state {
+		pid_t pid = -1;
+		int tasks = -1;					// the write end of the worker's task pipe
+		int results = -1;				// the read end of its result pipe
+		std::vector<unsigned char> buffer; // bytes read from the result pipe that don't make a whole frame yet
+		bool busy = false;
+		size_t next = 0;				// (busy) the next index of its shard to come back
+		size_t end = 0;					// (busy) the index after its shard
+		clock::time_point progress;		// (busy) when it last sent something back
+	};
+
+	std::vector<worker_state> workers((size_t)(config.workers));
+	corpus_cluster_report report;
+	report.workers.resize(workers.size());
+	auto start = clock::now();
+
+	std::signal(SIGPIPE, SIG_IGN); // a worker dying mid-shard makes our writes to it fail instead of killing us
+
+	auto spawn = [&](size_t w) { // fork a fresh worker into slot w
+		int tasks[2], results[2];
+		if (pipe(tasks) != 0) return false;
+		if (pipe(results) != 0) {
+			close(tasks[0]);
+			close(tasks[1]);
+			return false;
+		}
+
+		std::cout.flush(); // so nothing buffered gets written twice
+		std::cerr.flush();
+		pid_t pid = fork();
+		if (pid < 0) {
+			for (int fd : {tasks[0], tasks[1], results[0], results[1]}) close(fd);
+			return false;
+		}
+
+		if (pid == 0) { // the worker; it mustn't hold the other workers' pipes open, or the coordinator would never see them close
+			for (worker_state const& other : workers) {
+				if (other.tasks != -1) close(other.tasks);
+				if (other.results != -1) close(other.results);
+			}
+			close(tasks[1]);
+			close(results[0]);
+			std::signal(SIGPIPE, SIG_DFL);
+			corpus_worker(source, tasks[0], results[1], config.certificates, classify);
+			_exit(0); // skip the coordinator's destructors and atexit handlers
+		}
+
+		close(tasks[0]);
+		close(results[1]);
+		fcntl(results[0], F_SETFD, FD_CLOEXEC);
+		fcntl(tasks[1], F_SETFD, FD_CLOEXEC);
+		worker_state& ws = workers[w];
+		ws.pid = pid;
+		ws.tasks = tasks[1];
+		ws.results = results[0];
+		ws.buffer.clear();
+		ws.busy = false;
+		return true;
+	};
+
+	for (size_t w = 0; w < workers.size(); w++) {
+		if (!spawn(w)) throw std::runtime_error{"could not start a corpus worker"};
+	}
+
+	std::deque<std::pair<size_t, size_t>> queue; // ranges of indices left to send, in order (leftovers of crashed shards go in front)
+	size_t next_shard = 0;						 // the first index not yet split off into a shard
+	std::map<size_t, corpus_result> pending;	 // reorder buffer
+	size_t next_emit = 0;
+
+	auto emit_ready = [&] {
+		while (!pending.empty() && pending.begin()->first == next_emit) {
+			corpus_result& r = pending.begin()->second;
+			r.name = source.name(r.index);
+			report.items++;
+			report.loaded += r.loaded;
+			report.authenticated += r.authenticated;
+			report.gsp += r.is_gsp;
+			report.sp += r.is_sp;
+			report.op += r.is_op;
+			if (r.failed()) report.failures.push_back({r.index, r.name, r.error.empty() ? "result did not authenticate" : r.error});
+			emit(r);
+			pending.erase(pending.begin());
+			next_emit++;
+		}
+	};
+
+	auto retire = [&](size_t w, std::string const& why, bool blame) { // a busy worker died: blame the item it was on (unless it died before it could start the shard), requeue the rest of its shard, and replace it
+		worker_state& ws = workers[w];
+		close(ws.tasks);
+		close(ws.results);
+		int status = 0;
+		waitpid(ws.pid, &status, 0);
+		report.workers[w].crashes++;
+		ws.tasks = ws.results = -1;
+		ws.busy = false;
+
+		if (!blame) {
+			queue.emplace_front(ws.next, ws.end);
+			report.reassigned++;
+			if (!spawn(w)) throw std::runtime_error{"could not restart a corpus worker"};
+			return;
+		}
+
+		std::string error = why;
+		if (error.empty()) error = WIFSIGNALED(status) ? "worker crashed (signal " + std::to_string(WTERMSIG(status)) + ")" : "worker exited with status " + std::to_string(WEXITSTATUS(status));
+		corpus_result r;
+		r.index = ws.next;
+		r.error = error;
+		pending.emplace(r.index, std::move(r));
+		if (ws.next + 1 < ws.end) {
+			queue.emplace_front(ws.next + 1, ws.end);
+			report.reassigned++;
+		}
+
+		if (!spawn(w)) throw std::runtime_error{"could not restart a corpus worker"};
+		emit_ready();
+	};
+
+	std::vector<pollfd> fds;
+	std::vector<size_t> polled;
+	unsigned char chunk[1 << 16];
+
+	while (next_emit < source.size()) {
+		for (size_t w = 0; w < workers.size(); w++) { // hand shards to idle workers, while they're within the window
+			worker_state& ws = workers[w];
+			if (ws.busy) continue;
+			if (queue.empty() && next_shard < source.size() && next_shard < next_emit + config.window * config.shard_size) {
+				queue.emplace_back(next_shard, std::min(source.size(), next_shard + config.shard_size));
+				next_shard = queue.back().second;
+			}
+			if (queue.empty()) break;
+
+			uint64_t shard[2] = {queue.front().first, queue.front().second};
+			queue.pop_front();
+			ws.busy = true;
+			ws.next = (size_t)(shard[0]);
+			ws.end = (size_t)(shard[1]);
+			ws.progress = clock::now();
+			report.shards++;
+			report.workers[w].shards++;
+			if (!write_fully(ws.tasks, shard, sizeof(shard))) retire(w, "", false);
+		}
+
+		fds.clear();
+		polled.clear();
+		for (size_t w = 0; w < workers.size(); w++) {
+			if (!workers[w].busy) continue;
+			fds.push_back({workers[w].results, POLLIN, 0});
+			polled.push_back(w);
+		}
+		if (fds.empty()) break; // can't happen, since something is always in flight until everything is emitted
+
+		int timeout = config.item_timeout > 0 ? 100 : -1;
+		if (poll(fds.data(), (nfds_t)(fds.size()), timeout) < 0 && errno != EINTR) throw std::runtime_error{"poll failed"};
+
+		for (size_t p = 0; p < fds.size(); p++) {
+			size_t w = polled[p];
+			worker_state& ws = workers[w];
+
+			if (fds[p].revents == 0) {
+				if (config.item_timeout > 0 && std::chrono::duration<double>(clock::now() - ws.progress).count() > config.item_timeout) {
+					kill(ws.pid, SIGKILL);
+					retire(w, "timed out after " + std::to_string(config.item_timeout) + "s", true);
+				}
+				continue;
+			}
+
+			ssize_t got = read(ws.results, chunk, sizeof(chunk));
+			if (got < 0 && errno == EINTR) continue;
+			if (got <= 0) { // the worker died
+				retire(w, "", true);
+				continue;
+			}
+
+			ws.buffer.insert(ws.buffer.end(), chunk, chunk + got);
+			ws.progress = clock::now();
+
+			size_t used = 0;
+			while (true) { // take every whole frame out of the buffer
+				cert_reader in{ws.buffer.data() + used, ws.buffer.size() - used};
+				uint64_t length = in.varint();
+				if (!in.ok || in.remaining() < length) break;
+
+				corpus_result r;
+				if (!read_corpus_result(in.pos, (size_t)(length), r) || r.index != ws.next) { // a worker only ever sends what it was asked for, in order
+					kill(ws.pid, SIGKILL);
+					retire(w, "worker sent a malformed result", true);
+					used = 0;
+					break;
+				}
+
+				used = (size_t)(in.pos - ws.buffer.data()) + (size_t)(length);
+				report.workers[w].items++;
+				pending.emplace(r.index, std::move(r));
+				if (++ws.next == ws.end) ws.busy = false;
+			}
+			if (ws.results != -1) ws.buffer.erase(ws.buffer.begin(), ws.buffer.begin() + (std::ptrdiff_t)(used));
+		}
+
+		emit_ready();
+	}
+
+	for (worker_state& ws : workers) { // closing the task pipes tells the workers to exit
+		close(ws.tasks);
+		close(ws.results);
+		waitpid(ws.pid, nullptr, 0);
+	}
+
+	report.wall_seconds = std::chrono::duration<double>(clock::now() - start).count();
+	return report;
+}
+
+#endif
@@ -0,0 +1,335 @@
+// this file contains a staged pipeline for running the implementation over a corpus (directory) of graph files
+// reading, parsing, classifying/authenticating and visualizing each run on their own threads, with bounded queues between them so a slow stage applies backpressure instead of letting memory grow
+// results are handed back to the caller in the order of the (sorted) file list, no matter which order the classifiers finish in
+
+#ifndef __CORPUS_PIPELINE_HXX__
+#define __CORPUS_PIPELINE_HXX__
+
+#include "graph.hxx"
+#include "graph-normalization.hxx"
+#include "gsp-sp-op.hxx"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+template <typename T>
+struct bounded_queue { // blocking FIFO with a fixed capacity; push blocks while it's full, pop blocks while it's empty
+	bounded_queue(size_t capacity_, int producers_) : capacity{capacity_}, producers{producers_} {}
+
+	void push(T item) { // once the queue is closed, the item is dropped instead
+		std::unique_lock<std::mutex> lock{m};
+		not_full.wait(lock, [&] { return items.size() < capacity || closed; });
+		if (closed) return;
+		items.push_back(std::move(item));
+		not_empty.notify_one();
+	}
+
+	bool pop(T& out) { // returns false once every producer is done and the queue has drained, or straight away once it's closed
+		std::unique_lock<std::mutex> lock{m};
+		not_empty.wait(lock, [&] { return !items.empty() || producers == 0 || closed; });
+		if (items.empty() || closed) return false;
+
+		out = std::move(items.front());
+		items.pop_front();
+		not_full.notify_one();
+		return true;
+	}
+
+	void producer_done() { // every producer thread calls this exactly once when it will not push anything else
+		std::lock_guard<std::mutex> lock{m};
+		if (--producers == 0) not_empty.notify_all();
+	}
+
+	void close() { // give up on the queue: wake every thread blocked on it, and from now on drop whatever is pushed and pop nothing
+		std::lock_guard<std::mutex> lock{m};
+		closed = true;
+		items.clear();
+		not_full.notify_all();
+		not_empty.notify_all();
+	}
+
+private:
+	size_t capacity;
+	int producers;
+	bool closed = false;
+	std::deque<T> items;
+	std::mutex m;
+	std::condition_variable not_full;
+	std::condition_variable not_empty;
+};
+
+struct corpus_item { // one file as it moves through the pipeline
+	size_t index;					// position of the file in the corpus, which is also the order results are emitted in
+	std::filesystem::path path;
+	std::string text;				// raw file contents, filled in by the reader and released by the parser
+	graph g;
+	normalization_report normalization;	// what the parser's normalization pass removed from g, and how many components it has
+	gsp_sp_op_result result{};
+	bool loaded = false;			// true if the file was read and parsed successfully, and is connected once normalized
+	bool authenticated = false;		// true if result.authenticate(g) succeeded
+	std::string error;				// set if any stage failed on this file (the later stages skip it)
+	std::string report;				// free-form output produced by the classify callback, emitted in corpus order
+};
+
+struct corpus_pipeline_config {
+	int readers = 1;
+	int parsers = 1;
+	int classifiers = 0;			 // 0 means one per hardware thread (minus the reader and parser)
+	int visualizers = 1;
+	size_t queue_capacity = 8;		 // capacity of each inter-stage queue
+	size_t window = 64;				 // maximum number of files between the oldest not-yet-emitted file and the newest file being read, this bounds the reorder buffer
+	bool low_priority_visualization = true;
+};
+
+struct pipeline_stage_report {
+	std::string name;
+	int threads;
+	long items;
+	double busy_seconds;
+	double utilization; // busy time / (wall time * threads)
+};
+
+struct corpus_pipeline_report {
+	double wall_seconds = 0;
+	std::vector<pipeline_stage_report> stages;
+
+	void print(std::ostream& os) const {
+		os << "pipeline finished in " << std::fixed << std::setprecision(3) << wall_seconds << "s\n";
+		for (pipeline_stage_report const& s : stages) {
+			os << "  " << std::left << std::setw(12) << s.name << std::right << s.threads << (s.threads == 1 ? " thread,  " : " threads, ") << std::setw(7) << s.items << " items, "
+			   << std::setprecision(3) << s.busy_seconds << "s busy, " << std::setprecision(1) << 100.0 * s.utilization << "% utilized\n";
+		}
+		os << std::defaultfloat;
+	}
+};
+
+std::vector<std::filesystem::path> list_corpus_files(std::filesystem::path const& dir, std::string const& extension = ".txt") { // the immediate children of dir with the given extension, sorted so runs are reproducible (directory_iterator order is unspecified)
+	std::vector<std::filesystem::path> files;
+	for (auto const& entry : std::filesystem::directory_iterator{dir}) {
+		if (entry.path().extension() == extension) files.push_back(entry.path());
+	}
+
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+bool parse_corpus_graph(std::string const& text, graph& g) { // parse a graph in the usual input format from an in-memory string, failing if the input is truncated, the header is nonsense or an endpoint is out of range
+	std::istringstream in{text};
+	in >> g;
+	return !in.fail() && g.n > 0;
+}
+
+void load_corpus_item(corpus_item& item) { // parse and normalize the text of an item that was read, and release the text
+	item.loaded = parse_corpus_graph(item.text, item.g);
+	if (!item.loaded) {
+		item.error = "failed to read graph from file";
+	} else {
+		item.normalization = normalize_graph(item.g, normalization_config{1}); // one thread, since there's a parser thread (or worker process) per file already
+		if (!item.normalization.connected()) {
+			item.loaded = false;
+			item.error = "graph is not connected (" + std::to_string(item.normalization.components) + " components)";
+		}
+	}
+	std::string{}.swap(item.text); // the text is dead weight from here on
+}
+
+void classify_corpus_item(corpus_item& item, std::function<void(corpus_item&)> const& classify) { // run GSP_SP_OP on a loaded item, authenticate the result, and do any extra work, turning exceptions into errors
+	try {
+		item.result = GSP_SP_OP(item.g);
+		item.authenticated = item.result.authenticate(item.g);
+		if (classify) classify(item);
+	} catch (std::exception const& ex) {
+		item.error = ex.what();
+	} catch (...) {
+		item.error = "unknown exception during classification";
+	}
+}
+
+corpus_pipeline_report run_corpus_pipeline(std::vector<std::filesystem::path> const& files,
+										   corpus_pipeline_config config,
+										   std::function<void(corpus_item&)> const& classify,  // extra per-file work done on the classifier threads after GSP_SP_OP and authentication (may be empty)
+										   std::function<void(corpus_item&)> const& emit,	   // called on the calling thread, once per file, in corpus order
+										   std::function<void(corpus_item&)> const& visualize) { // called on the visualizer threads after a file is emitted (may be empty, in which case there is no visualization stage)
+	using item_ptr = std::unique_ptr<corpus_item>;
+	using clock = std::chrono::steady_clock;
+
+	if (config.classifiers <= 0) config.classifiers = std::max(1, (int)(std::thread::hardware_concurrency()) - config.readers - config.parsers);
+	if (!visualize) config.visualizers = 0;
+	if (config.window < config.queue_capacity) config.window = config.queue_capacity;
+
+	enum { reading, parsing, classifying, visualizing, n_stages };
+	std::atomic<long long> busy_ns[n_stages] = {};
+	std::atomic<long> stage_items[n_stages] = {};
+	int stage_threads[n_stages] = {config.readers, config.parsers, config.classifiers, config.visualizers};
+	static const char * stage_names[n_stages] = {"read", "parse", "classify", "visualize"};
+
+	auto timed = [&](int stage, auto&& work) { // run one unit of work for a stage and charge its time to that stage
+		auto start = clock::now();
+		work();
+		busy_ns[stage] += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+		stage_items[stage]++;
+	};
+
+	bounded_queue<item_ptr> read_q{config.queue_capacity, config.readers};
+	bounded_queue<item_ptr> parse_q{config.queue_capacity, config.parsers};
+	bounded_queue<item_ptr> classify_q{config.queue_capacity, config.classifiers};
+	bounded_queue<item_ptr> visual_q{config.queue_capacity, 1}; // the only producer is the emitter
+
+	std::mutex window_m; // readers claim file indices in order, but never more than config.window past the next file to be emitted
+	std::condition_variable window_cv;
+	size_t next_claim = 0;
+	size_t next_emit = 0;
+	bool stopping = false; // set if emit throws, so the readers stop claiming files
+
+	auto start = clock::now();
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < config.readers; i++) {
+		threads.emplace_back([&] {
+			while (true) {
+				size_t index;
+				{
+					std::unique_lock<std::mutex> lock{window_m};
+					window_cv.wait(lock, [&] { return stopping || next_claim >= files.size() || next_claim < next_emit + config.window; });
+					if (stopping || next_claim >= files.size()) break;
+					index = next_claim++;
+				}
+
+				item_ptr item{new corpus_item{}};
+				item->index = index;
+				item->path = files[index];
+				timed(reading, [&] {
+					std::ifstream fin{item->path, std::ios::binary};
+					if (!fin) {
+						item->error = "cannot open file";
+						return;
+					}
+					std::ostringstream contents;
+					contents << fin.rdbuf();
+					item->text = std::move(contents).str();
+				});
+				read_q.push(std::move(item));
+			}
+			read_q.producer_done();
+		});
+	}
+
+	for (int i = 0; i < config.parsers; i++) {
+		threads.emplace_back([&] {
+			item_ptr item;
+			while (read_q.pop(item)) {
+				if (item->error.empty()) {
+					timed(parsing, [&] {
+						load_corpus_item(*item);
+					});
+				}
+				parse_q.push(std::move(item));
+			}
+			parse_q.producer_done();
+		});
+	}
+
+	for (int i = 0; i < config.classifiers; i++) {
+		threads.emplace_back([&] {
+			item_ptr item;
+			while (parse_q.pop(item)) {
+				if (item->loaded) {
+					timed(classifying, [&] {
+						classify_corpus_item(*item, classify);
+					});
+				}
+				classify_q.push(std::move(item));
+			}
+			classify_q.producer_done();
+		});
+	}
+
+	for (int i = 0; i < config.visualizers; i++) {
+		threads.emplace_back([&] {
+			#ifdef __linux__
+			if (config.low_priority_visualization) setpriority(PRIO_PROCESS, (id_t)(syscall(SYS_gettid)), 10); // on linux niceness is per-thread, so this only demotes the visualizer (if it fails we just run at normal priority)
+			#endif
+
+			item_ptr item;
+			while (visual_q.pop(item)) {
+				if (item->loaded && item->error.empty()) {
+					timed(visualizing, [&] {
+						try {
+							visualize(*item);
+						} catch (...) {} // a failed drawing shouldn't take the run down with it
+					});
+				}
+			}
+		});
+	}
+
+	std::map<size_t, item_ptr> pending; // reorder buffer, holds at most config.window items
+	item_ptr item;
+	try {
+		while (classify_q.pop(item)) {
+			pending.emplace(item->index, std::move(item));
+
+			while (!pending.empty() && pending.begin()->first == next_emit) {
+				item_ptr ready = std::move(pending.begin()->second);
+				pending.erase(pending.begin());
+				emit(*ready);
+
+				{
+					std::lock_guard<std::mutex> lock{window_m};
+					next_emit++;
+				}
+				window_cv.notify_all();
+
+				if (config.visualizers > 0) visual_q.push(std::move(ready));
+			}
+		}
+	} catch (...) { // emit threw: stop every stage (each thread finishes the file it's on at most), join them all so none is left joinable, and pass the exception on
+		{
+			std::lock_guard<std::mutex> lock{window_m};
+			stopping = true;
+		}
+		window_cv.notify_all();
+		read_q.close();
+		parse_q.close();
+		classify_q.close();
+		visual_q.close();
+		for (std::thread& t : threads) t.join();
+		throw;
+	}
+	visual_q.producer_done();
+
+	for (std::thread& t : threads) t.join();
+
+	corpus_pipeline_report report;
+	report.wall_seconds = std::chrono::duration<double>(clock::now() - start).count();
+	for (int s = 0; s < n_stages; s++) {
+		if (stage_threads[s] == 0) continue;
+		double busy = (double)(busy_ns[s].load()) / 1e9;
+		report.stages.push_back({stage_names[s], stage_threads[s], stage_items[s].load(), busy, (report.wall_seconds > 0 ? busy / (report.wall_seconds * stage_threads[s]) : 0)});
+	}
+
+	return report;
+}
+
+#endif
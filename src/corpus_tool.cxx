@@ -0,0 +1,53 @@
+// this classifies a whole corpus on several worker processes (see corpus-coordinator.hxx), or packs a directory of graph files into one pack file for it
+// usage: corpus_tool pack <directory> <pack file>
+//        corpus_tool run <directory or pack file> [workers] [certificate directory]
+// run lists every graph that failed to load or authenticate, then prints the merged report; with a certificate directory it also writes the certificates of every graph there (as <name>.cert)
+
+#include "corpus-coordinator.hxx"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char ** argv) {
+	std::string mode = argc > 1 ? argv[1] : "";
+	if (!((mode == "pack" && argc == 4) || (mode == "run" && argc >= 3 && argc <= 5))) {
+		std::cerr << "usage: " << argv[0] << " pack <directory> <pack file>\n"
+				  << "       " << argv[0] << " run <directory or pack file> [workers] [certificate directory]\n";
+		return 2;
+	}
+
+	corpus_source source;
+	if (!open_corpus(argv[2], source)) {
+		std::cerr << "failed to open " << argv[2] << " as a directory or pack file\n";
+		return 2;
+	}
+
+	if (mode == "pack") {
+		if (!write_corpus_pack(source, argv[3])) {
+			std::cerr << "failed to write " << argv[3] << "\n";
+			return 1;
+		}
+
+		std::cout << "packed " << source.size() << " graphs into " << argv[3] << "\n";
+		return 0;
+	}
+
+	corpus_cluster_config config;
+	config.workers = argc > 3 ? std::atoi(argv[3]) : 0;
+	std::filesystem::path certificates = argc > 4 ? argv[4] : "";
+	config.certificates = !certificates.empty();
+	if (config.certificates) std::filesystem::create_directories(certificates);
+
+	corpus_cluster_report report = run_corpus_cluster(source, config, nullptr, [&](corpus_result& r) {
+		if (r.failed()) std::cout << r.name << ": " << (r.error.empty() ? "result did not authenticate" : r.error) << "\n";
+		if (config.certificates && !r.certificates.empty()) {
+			std::ofstream out{certificates / (r.name + ".cert"), std::ios::binary};
+			out.write((char const *)(r.certificates.data()), (std::streamsize)(r.certificates.size()));
+		}
+	});
+
+	report.print(std::cout);
+	return report.failures.empty() ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// this file contains a repair engine, which finds a set of edges whose removal makes a graph GSP (or OP), and a positive certificate for the graph without them
+// the obvious way is to classify the graph, remove an edge of the K4 (or K23) it gives, and start over, which classifies the whole graph once per edge removed
+// instead, removing an edge only ever removes obstructions, so whatever has been found free of them stays that way; the engine splits the graph into its bicomps (an obstruction lies within one) and cleans each one on its own, as an induced subgraph view (see graph.hxx)
+// a bicomp with more than one obstruction is cleaned through levels of windows, connected pieces of it of increasing size, so most edges removed cost another look at just the window they were found in rather than at the whole graph
+// the graph is classified as a whole twice at the start, as rerunning would, so a graph with a single obstruction costs no more than that; past those, only once more at the end for the certificate, unless the last check of a bicomp spanning the graph already gave one
+
+#ifndef __EDGE_REPAIR_HXX__
+#define __EDGE_REPAIR_HXX__
+
+#include "graph.hxx"
+#include "gsp-sp-op.hxx"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class repair_target {gsp, op};
+
+struct repair_config {
+	repair_target target = repair_target::gsp; // GSP only needs the K4s gone, OP the K23s too
+	int window = 64;							// the size of the smallest windows a bicomp is cleaned through, at least 4
+	int growth = 2;								// and how many times bigger each level of windows is than the one before (at least 2), until they'd be as big as the bicomp
+};
+
+struct repair_result {
+	bool repaired = false;		// false if the graph couldn't be repaired (it had fewer than 2 vertices or was disconnected, neither of which GSP_SP_OP handles, or the config was invalid), saying why in error
+	std::string error;
+	std::vector<edge_t> removed; // the edges removed, in the order they were
+	graph g;					 // the graph without them
+	gsp_sp_op_result result{};	 // the classification of g, whose gsp_reason (or op_reason, for OP) is a positive certificate
+	int classifications = 0;	 // how many graphs, bicomps and windows were classified along the way
+	long long classified_size = 0; // and their total size (vertices plus edges), which is most of the work
+};
+
+certificate const * repair_obstruction(gsp_sp_op_result const& r, repair_target target) { // the obstruction a result gives to the target class (a K4, or for OP possibly a K23), or null if the graph is in it
+	if (!r.is_gsp) return r.gsp_reason.get();
+	if (target == repair_target::op && !r.is_op) return r.op_reason.get();
+	return nullptr;
+}
+
+edge_t obstruction_edge(certificate const * cert) { // the edge of a K4 or K23 subdivision to remove: the middle of its shortest path, so an edge between two of its terminating vertices goes first
+	std::vector<std::vector<edge_t> const *> paths;
+	if (auto k4 = dynamic_cast<negative_cert_K4 const *>(cert)) paths = {&k4->ab, &k4->ac, &k4->ad, &k4->bc, &k4->bd, &k4->cd};
+	if (auto k23 = dynamic_cast<negative_cert_K23 const *>(cert)) paths = {&k23->one, &k23->two, &k23->three};
+
+	std::vector<edge_t> const * shortest = nullptr;
+	for (auto path : paths) {
+		if (!path->empty() && (!shortest || path->size() < shortest->size())) shortest = path;
+	}
+	return shortest ? (*shortest)[shortest->size() / 2] : edge_t{-1, -1};
+}
+
+void remove_edge(graph& g, int u, int v) { // remove edge uv from g, keeping the order of both adjacency lists, in O(deg(u) + deg(v)) time
+	std::vector<int>& from_u = g.adjLists[u];
+	std::vector<int>& from_v = g.adjLists[v];
+	from_u.erase(std::find(from_u.begin(), from_u.end(), v));
+	from_v.erase(std::find(from_v.begin(), from_v.end(), u));
+	g.e--;
+}
+
+struct repair_workspace { // the state of one repair: the graph being repaired, a subgraph_workspace to view its bicomps and windows through, and host-sized scratch arrays, stamped so they never need clearing
+	repair_config config;
+	repair_result out;
+	subgraph_workspace views;
+	int min_cycles;				// the fewest independent cycles an obstruction has (3 for a K4, 2 for a K23), so subgraphs with fewer needn't be classified
+	int stamp = 0;
+	bool final = false;			// whether out.result is a classification of the graph as it is now, with no obstruction
+	std::vector<int> all;		// every vertex, in order
+	std::vector<int> member;	// member[v] is the stamp of the subgraph being split up that v was last marked in
+	std::vector<int> placed;	// placed[v] is the stamp of the round of windows that last put v in a window
+	std::vector<int> disc, low; // for splitting a bicomp
+
+	repair_workspace(graph const& g, repair_config const& config_) : config{config_}, out{false, {}, {}, g}, views{out.g},
+		min_cycles{config_.target == repair_target::gsp ? 3 : 2}, all((size_t)(g.n)), member((size_t)(g.n), 0), placed((size_t)(g.n), 0), disc((size_t)(g.n), 0), low((size_t)(g.n), 0) {
+		for (int v = 0; v < g.n; v++) all[v] = v;
+	}
+
+	repair_workspace(repair_workspace const&) = delete; // views holds a reference to out.g
+
+	void remove(edge_t e, int const * global) { // remove an edge of a view (or of the graph itself, if global is null)
+		if (global) e = {global[e.first], global[e.second]};
+		remove_edge(out.g, e.first, e.second);
+		out.removed.push_back(e);
+		final = false;
+	}
+
+	bool fix_graph() { // classify the whole graph and remove an edge of the obstruction it has, if any, returning whether it had one; if it had none, out.result is the final classification
+		out.result = GSP_SP_OP(out.g);
+		out.classifications++;
+		out.classified_size += out.g.n + out.g.e;
+		if (certificate const * cert = repair_obstruction(out.result, config.target)) {
+			remove(obstruction_edge(cert), nullptr);
+			return true;
+		}
+		final = true;
+		return false;
+	}
+
+	bool fix(std::vector<int> const& vertices) { // classify the subgraph induced by vertices and remove an edge of the obstruction it has, if any, returning whether it had one
+											   // every edge of an obstruction is on a cycle, so removing one never disconnects the subgraph (or the graph)
+		if (vertices.size() == all.size() && std::is_sorted(vertices.begin(), vertices.end())) return fix_graph(); // the subgraph is the whole graph, numbered the same, so its classification can be the final one
+		subgraph_view view;
+		bool found = false;
+		if (views.bind(vertices, view) && view.e - view.n + 1 >= min_cycles) {
+			gsp_sp_op_result r = GSP_SP_OP(view);
+			out.classifications++;
+			out.classified_size += view.n + view.e;
+			if (certificate const * cert = repair_obstruction(r, config.target)) {
+				remove(obstruction_edge(cert), view.global);
+				found = true;
+			}
+		}
+		views.unbind();
+		return found;
+	}
+
+	void split(std::vector<int> const& vertices, std::vector<std::vector<int>>& bicomps) { // add the bicomps of the (connected) subgraph induced by vertices to bicomps, leaving out the ones with fewer than 4 vertices, which can't hold an obstruction
+																							// an iterative DFS keeping the vertices on a stack; a child whose subtree has no back edge above its parent closes a bicomp
+		stamp++;
+		for (int v : vertices) {
+			member[v] = stamp;
+			disc[v] = 0;
+		}
+
+		std::vector<std::pair<int, int>> frames{{vertices[0], 0}}; // each vertex on the DFS path and how far along its adjacency list we are
+		std::vector<int> stack{vertices[0]};
+		int time = 1;
+		disc[vertices[0]] = low[vertices[0]] = time;
+
+		while (!frames.empty()) {
+			int w = frames.back().first;
+			int& i = frames.back().second;
+			if (i < out.g.degree(w)) {
+				int u = out.g.adjLists[w][i++];
+				if (member[u] != stamp) continue; // outside the subgraph
+				if (disc[u] == 0) {
+					disc[u] = low[u] = ++time;
+					stack.push_back(u);
+					frames.emplace_back(u, 0);
+				} else {
+					low[w] = std::min(low[w], disc[u]); // the edge to the parent lowers low[w] to the parent's number at most, which doesn't change which children close bicomps
+				}
+				continue;
+			}
+
+			frames.pop_back();
+			if (frames.empty()) break;
+			int p = frames.back().first;
+			low[p] = std::min(low[p], low[w]);
+			if (low[w] >= disc[p]) { // w's subtree and p make up a bicomp
+				std::vector<int> bicomp{p};
+				int x;
+				do {
+					x = stack.back();
+					stack.pop_back();
+					bicomp.push_back(x);
+				} while (x != w);
+				if (bicomp.size() >= 4) bicomps.push_back(std::move(bicomp));
+			}
+		}
+	}
+
+	void partition(std::vector<int> const& vertices, int size, bool backwards, size_t smallest, std::vector<std::vector<int>>& windows) { // split the (connected) subgraph induced by vertices into disjoint windows of up to size vertices, each grown by a BFS (so it's connected) from the first vertex (or the last, if backwards) not in one yet
+		int in_region = ++stamp;
+		for (int v : vertices) member[v] = in_region;
+		int round = ++stamp;
+
+		for (size_t k = 0; k < vertices.size(); k++) {
+			int seed = vertices[backwards ? vertices.size() - 1 - k : k];
+			if (placed[seed] == round) continue;
+			std::vector<int> window{seed};
+			placed[seed] = round;
+			for (size_t i = 0; i < window.size() && (int)(window.size()) < size; i++) {
+				for (int u : out.g.adjLists[window[i]]) {
+					if (member[u] != in_region || placed[u] == round) continue;
+					placed[u] = round;
+					window.push_back(u);
+					if ((int)(window.size()) == size) break;
+				}
+			}
+			if (window.size() >= smallest) windows.push_back(std::move(window));
+		}
+	}
+
+	void clean(std::vector<int> const& bicomp) { // remove edges from a bicomp until it has no obstruction
+												  // it's checked again after removing an edge of the first obstruction, so a bicomp with just one costs no more than rerunning
+		if (!fix(bicomp) || !fix(bicomp)) return;
+		clean_through_windows(bicomp);
+	}
+
+	void clean_through_windows(std::vector<int> const& bicomp) { // remove edges from a bicomp with more than one obstruction through windows of increasing size, each level split up from the other end of the bicomp from the one before, so an obstruction across windows of one level is likely within one of the next
+		bool backwards = false;
+		for (long long size = config.window; size < (long long)(bicomp.size()); size *= config.growth) {
+			std::vector<std::vector<int>> windows;
+			partition(bicomp, (int)(size), backwards, 4, windows); // smaller windows can't hold an obstruction
+			for (std::vector<int> const& window : windows) {
+				while (fix(window)) {}
+			}
+			backwards = !backwards;
+		}
+
+		if (fix(bicomp)) { // what's left lies across the biggest windows, and removing an edge of it may well have split the bicomp up, so the rest is looked for in the bicomps it's split into
+			std::vector<std::vector<int>> parts;
+			split(bicomp, parts);
+			for (std::vector<int> const& part : parts) {
+				while (fix(part)) {}
+			}
+		}
+	}
+
+	void run() {
+		if (config.window < 4 || config.growth < 2) { // smaller windows can't hold an obstruction, and windows that don't grow never get as big as the bicomp
+			out.error = "the window must be at least 4 and the growth at least 2";
+			return;
+		}
+		if (out.g.n < 2) {
+			out.error = "graph has fewer than 2 vertices";
+			return;
+		}
+		std::vector<std::vector<int>> reached;
+		partition(all, out.g.n, false, 1, reached); // one BFS from vertex 0 reaches everything if the graph is connected
+		if (reached.size() != 1 || (int)(reached[0].size()) != out.g.n) {
+			out.error = "graph is disconnected";
+			return;
+		}
+
+		if (fix_graph() && fix_graph()) { // most graphs need no repair, and most of the rest just one edge, so the whole graph is checked twice like rerunning would before anything cleverer
+			std::vector<std::vector<int>> bicomps; // obstructions lie within bicomps, so each is cleaned on its own
+			split(all, bicomps);
+			if (bicomps.size() == 1 && bicomps[0].size() == all.size()) {
+				clean_through_windows(all); // the graph is one bicomp and was just checked twice, and in order, so its last check can be the final classification
+			} else {
+				for (std::vector<int> const& bicomp : bicomps) clean(bicomp);
+			}
+		}
+
+		if (!final) fix_graph();
+		out.repaired = final;
+		if (!out.repaired) out.error = "the graph still has an obstruction after repair"; // can't happen, since every bicomp was cleaned as a whole
+	}
+};
+
+repair_result repair_graph(graph const& g, repair_config const& config = {}) { // find edges whose removal makes g (connected) GSP, or OP, and classify g without them
+	repair_workspace workspace{g, config};
+	workspace.run();
+	return std::move(workspace.out);
+}
+
+#endif
@@ -0,0 +1,99 @@
+// this times the streaming exporters in sp-export.hxx on one large random GSP graph against classifying it, writing to a stream that only counts bytes (so the disk isn't measured)
+// for every format it exports the graph, the full decomposition tree, and the summary of the tree, and reports how long each took, how much it wrote, and how many nodes the summary kept
+// optional command line arguments: the order of the graph (default 1000000), and a directory to also write every export to as files
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "sp-export.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+struct counting_buffer : std::streambuf { // a stream buffer that throws away everything written to it, counting the bytes and the lines
+	char buffer[1 << 16];
+	long long bytes = 0;
+	long long lines = 0;
+
+	counting_buffer() {setp(buffer, buffer + sizeof(buffer));}
+
+	void drain() {
+		bytes += pptr() - pbase();
+		lines += std::count(pbase(), pptr(), '\n');
+		setp(buffer, buffer + sizeof(buffer));
+	}
+
+	int overflow(int c) override {
+		drain();
+		if (c != traits_type::eof()) {
+			*pptr() = (char)(c);
+			pbump(1);
+		}
+		return c == traits_type::eof() ? 0 : c;
+	}
+
+	int sync() override {
+		drain();
+		return 0;
+	}
+};
+
+template <typename Export>
+void measure(char const * what, char const * format_name, Export run, std::string const& file) { // run an export into a counting stream, and into file too if there is one
+	counting_buffer counter;
+	std::ostream os{&counter};
+	auto start = std::chrono::steady_clock::now();
+	run(os);
+	os.flush();
+	double time = seconds_since(start);
+	std::cout << "  " << std::left << std::setw(14) << what << std::setw(8) << format_name << std::right << std::setprecision(3) << std::setw(7) << time << "s, " << std::setprecision(1) << std::setw(8) << counter.bytes / 1e6 << " MB, " << std::setw(9) << counter.lines << " lines\n";
+
+	if (!file.empty()) {
+		std::ofstream out{file};
+		run(out);
+	}
+}
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	std::string dir = argc > 2 ? argv[2] : "";
+	graph const g = random_gsp_graph(n, 36);
+	std::cout << "random GSP graph with " << g.n << " vertices and " << g.e << " edges\n" << std::fixed;
+
+	auto start = std::chrono::steady_clock::now();
+	gsp_sp_op_result r = GSP_SP_OP(g);
+	double classify_time = seconds_since(start);
+	auto gsp = std::dynamic_pointer_cast<positive_cert_gsp>(r.gsp_reason);
+	if (!gsp) {
+		std::cout << "the graph was not classified as GSP\n";
+		return 1;
+	}
+
+	flat_sp_tree const& tree = gsp->decomposition;
+	std::cout << "classifying took " << std::setprecision(3) << classify_time << "s, the decomposition tree has " << tree.nodes.size() << " nodes\n";
+
+	export_format formats[3] = {export_format::dot, export_format::json, export_format::graphml};
+	char const * names[3] = {"DOT", "JSON", "GraphML"};
+	char const * extensions[3] = {".dot", ".json", ".graphml"};
+	sp_export_config summary;
+	summary.summarize = true;
+
+	for (int f = 0; f < 3; f++) {
+		auto file = [&](char const * stem) {return dir.empty() ? std::string{} : (std::filesystem::path{dir} / (std::string{stem} + extensions[f])).string();};
+		measure("graph", names[f], [&](std::ostream& os) {export_graph(g, os, formats[f]);}, file("graph"));
+		measure("full tree", names[f], [&](std::ostream& os) {export_sp_tree(tree, os, formats[f]);}, file("sp_tree"));
+		measure("tree summary", names[f], [&](std::ostream& os) {export_sp_tree(tree, os, formats[f], summary);}, file("sp_tree_summary"));
+	}
+
+	return 0;
+}
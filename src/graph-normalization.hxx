@@ -0,0 +1,177 @@
+// this file contains the input normalization stage, a linear-time pass that turns the adjacency lists of a graph as it was read (or built) into the simple graph the implementation assumes, and reports what it had to change and whether the graph is connected
+// it removes entries out of range, self-loops and parallel edges, and recomputes g.e; run it on any graph that doesn't come from a trusted generator before passing it to GSP_SP_OP
+
+#ifndef __GRAPH_NORMALIZATION_HXX__
+#define __GRAPH_NORMALIZATION_HXX__
+
+#include "graph.hxx"
+#include <algorithm>
+#include <atomic>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct normalization_config {
+	int threads = 0;					// 0 means one per hardware thread on graphs with at least parallel_threshold adjacency list entries, and one thread otherwise
+	long long parallel_threshold = 1 << 20;
+	int block = 4096;					// number of consecutive vertices a thread claims at a time
+};
+
+struct normalization_report {
+	int stated_edges = 0;				// g.e before normalization (which need not have matched the adjacency lists)
+	long long out_of_range = 0;			// adjacency list entries naming a vertex outside [0, n), which were dropped
+	long long self_loops = 0;			// self-loops removed (add_edge(u, u) puts u into its own list twice, which counts as one self-loop)
+	long long parallel_edges = 0;		// extra copies of an edge removed (every copy after the first in the adjacency list of the lower endpoint)
+	int components = 0;					// connected components of the normalized graph
+	int threads = 1;					// threads the pass ran on
+
+	bool simple() const {return out_of_range == 0 && self_loops == 0 && parallel_edges == 0;} // whether the adjacency lists were left as they were
+	bool connected() const {return components == 1;}
+
+	void print(std::ostream& os) const {
+		os << "removed " << out_of_range << " entries out of range, " << self_loops << " self-loops and " << parallel_edges << " parallel edges; " << components << " connected component" << (components == 1 ? "" : "s") << "\n";
+	}
+};
+
+struct concurrent_union_find { // union-find that any number of threads can unite in at once; a root is only ever linked below a root with a smaller number, and paths are halved with CAS, so every parent pointer only ever moves towards the root
+	std::vector<std::atomic<int>> parent;
+
+	explicit concurrent_union_find(int n) : parent((size_t)(n)) {
+		for (int i = 0; i < n; i++) parent[i].store(i, std::memory_order_relaxed);
+	}
+
+	int find(int v) {
+		while (true) {
+			int p = parent[v].load();
+			if (p == v) return v;
+
+			int gp = parent[p].load();
+			if (gp != p) parent[v].compare_exchange_weak(p, gp); // halve the path; it doesn't matter if another thread got there first
+			v = gp;
+		}
+	}
+
+	void unite(int a, int b) {
+		while (true) {
+			a = find(a);
+			b = find(b);
+			if (a == b) return;
+			if (a < b) std::swap(a, b);
+
+			int expected = a;
+			if (parent[a].compare_exchange_strong(expected, b)) return; // a was still a root, so it now hangs below b; otherwise someone linked it first and we retry from the new roots
+		}
+	}
+};
+
+struct neighbor_set { // the neighbours kept so far in the list being compacted, when it's too long to scan; an open-addressing hash set sized to at least twice the longest list it's been used for, and emptied after each list by clearing just the slots that list filled
+	std::vector<int> slots;
+	int shift = 32;
+
+	void fit(size_t entries) {
+		if (2 * entries <= slots.size()) return;
+		size_t size = 64;
+		for (shift = 26; size < 2 * entries; size *= 2) shift--;
+		slots.assign(size, -1);
+	}
+
+	size_t slot(int v) const { // Fibonacci hashing; the top bits of the product are the well-mixed ones
+		size_t i = (size_t)(((unsigned)(v) * 2654435769u) >> shift);
+		while (slots[i] != -1 && slots[i] != v) i = (i + 1) & (slots.size() - 1);
+		return i;
+	}
+
+	bool insert(int v) { // false if v was already in the set
+		size_t i = slot(v);
+		if (slots[i] == v) return false;
+		slots[i] = v;
+		return true;
+	}
+
+	void clear(std::vector<int> const& kept) {
+		for (auto v = kept.rbegin(); v != kept.rend(); ++v) slots[slot(*v)] = -1; // the set holds exactly the kept entries, in the order they were inserted; taking them out last first never breaks the probe sequence of one still in it
+	}
+};
+
+normalization_report normalize_graph(graph& g, normalization_config const& config = normalization_config{}) { // normalize g in place in O(|V| + |E|) time, keeping the first copy of every edge in each list (so a simple graph's lists are left exactly as they were)
+	normalization_report report;
+	report.stated_edges = g.e;
+	int n = std::max(g.n, 0);
+	g.adjLists.resize((size_t)(n)); // a graph built by hand may not have a list for every vertex yet
+
+	long long entries = 0;
+	for (std::vector<int> const& list : g.adjLists) entries += (long long)(list.size());
+
+	int threads = config.threads;
+	if (threads <= 0) threads = entries >= config.parallel_threshold ? (int)(std::thread::hardware_concurrency()) : 1;
+	threads = std::max(1, std::min(threads, (n + config.block - 1) / std::max(config.block, 1)));
+	report.threads = threads;
+
+	concurrent_union_find components{n};
+	std::atomic<int> next_block{0};
+	std::vector<normalization_report> partial((size_t)(threads));
+	std::vector<long long> edges((size_t)(threads), 0);
+	size_t const short_list = 16; // lists up to this long are scanned for repeats, which is quicker than hashing at that length
+
+	auto work = [&](int t) { // each thread claims blocks of vertices and compacts their lists on its own, spotting a repeat of v in u's list without sorting anything: a short list is scanned for it, and a long one looks it up in the thread's own neighbor_set, so a thread needs memory for the longest list it compacts rather than a marker array for the whole graph
+		neighbor_set seen;
+		normalization_report& r = partial[t];
+		long long loop_entries = 0;
+
+		for (int first = next_block.fetch_add(config.block); first < n; first = next_block.fetch_add(config.block)) {
+			int last = std::min(n, first + config.block);
+			for (int u = first; u < last; u++) {
+				std::vector<int>& list = g.adjLists[u];
+				bool hashed = list.size() > short_list;
+				if (hashed) seen.fit(list.size());
+				size_t kept = 0;
+				for (int v : list) {
+					if (v < 0 || v >= n) {
+						r.out_of_range++;
+					} else if (v == u) {
+						loop_entries++;
+					} else if (hashed ? !seen.insert(v) : std::find(list.begin(), list.begin() + kept, v) != list.begin() + kept) {
+						if (u < v) r.parallel_edges++;
+					} else {
+						list[kept++] = v;
+						if (u < v) {
+							edges[t]++;
+							components.unite(u, v);
+						}
+					}
+				}
+				list.resize(kept);
+				if (hashed) seen.clear(list);
+			}
+		}
+
+		r.self_loops = (loop_entries + 1) / 2;
+	};
+
+	if (threads == 1) {
+		work(0);
+	} else {
+		std::vector<std::thread> pool;
+		for (int t = 0; t < threads; t++) pool.emplace_back(work, t);
+		for (std::thread& th : pool) th.join();
+	}
+
+	long long e = 0;
+	for (int t = 0; t < threads; t++) {
+		report.out_of_range += partial[t].out_of_range;
+		report.self_loops += partial[t].self_loops;
+		report.parallel_edges += partial[t].parallel_edges;
+		e += edges[t];
+	}
+
+	for (int v = 0; v < n; v++) {
+		if (components.parent[v].load(std::memory_order_relaxed) == v) report.components++;
+	}
+
+	g.n = n;
+	g.e = (int)(e);
+	return report;
+}
+
+#endif
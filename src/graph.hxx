@@ -4,6 +4,9 @@
 #define __GRAPH_HXX__
 
 #include "logging.hxx"
+#include "page-allocator.hxx"
+#include <cstdint>
+#include <numeric>
 #include <vector>
 #include <istream>
 #include <ostream>
@@ -23,15 +26,21 @@ struct graph {
 		return false;
 	}
 
+	// the implementation reads graphs through the three functions below (and n and adjacent), so anything else providing them, like a subgraph_view, can be classified and authenticated the same way
+	int degree(int v) const {return (int)(adjLists[v].size());}				// the length of v's adjacency list
+	int neighbor(int v, int i) const {return adjLists[v][i];}					// entry i of v's adjacency list (a subgraph_view returns -1 for entries outside the view, which callers skip)
+	std::vector<int> const& neighbors(int v) const {return adjLists[v];}	// all of the neighbours of v, for range-based loops
+
 	void add_edge(int e1, int e2) {
 		adjLists[e1].push_back(e2);
 		adjLists[e2].push_back(e1);
 	}
 
-	void reserve(graph const& other) {
+	template <typename Graph>
+	void reserve(Graph const& other) { // room for the adjacency lists of other (of any graph type)
 		for (int i = 0; i < other.n; i++) {
 			adjLists.emplace_back();
-			adjLists[i].reserve(other.adjLists[i].size());
+			adjLists[i].reserve((size_t)(other.degree(i)));
 		}
 	}
 
@@ -46,9 +55,240 @@ struct graph {
 	}
 };
 
+struct filtered_neighbors { // the entries of a host adjacency list that are inside a subgraph_view, translated to local vertex numbers
+	int const * first;
+	int const * last;
+	int const * local;
+
+	struct iterator {
+		int const * p;
+		int const * last;
+		int const * local;
+
+		void skip() {while (p != last && local[*p] == -1) p++;} // move past entries outside the view
+		int operator*() const {return local[*p];}
+		iterator& operator++() {
+			p++;
+			skip();
+			return *this;
+		}
+		bool operator!=(iterator const& other) const {return p != other.p;}
+	};
+
+	iterator begin() const {
+		iterator it{first, last, local};
+		it.skip();
+		return it;
+	}
+	iterator end() const {return iterator{last, last, local};}
+};
+
+struct member_list { // the stretch of host vertex numbers a subgraph_view reads a vertex's neighbours from
+	int const * first;
+	int const * last;
+};
+
+struct subgraph_view { // the subgraph of a host graph induced by a subset of its vertices, numbered 0 to n - 1 in the order the subset was given
+					   // it reads most host adjacency lists in place, skipping the entries outside the subset; a vertex with most of its list outside (a hub, say) has the rest copied by the subgraph_workspace when the view is bound, so it's never scanned in full again
+	graph const * host;
+	int n;					   // number of vertices in the view
+	int e;					   // number of edges of the host between them
+	int const * global;		   // global[v] is the host vertex of local vertex v
+	int const * local;		   // local[h] is the local vertex of host vertex h, or -1 if it's outside the view
+	member_list const * lists; // lists[v] is the host adjacency list of global[v], or the copy of its entries inside the view
+
+	int degree(int v) const {return (int)(lists[v].last - lists[v].first);} // the length of the list v's neighbours are read from, entries outside the view included
+	int neighbor(int v, int i) const {return local[lists[v].first[i]];}
+	filtered_neighbors neighbors(int v) const {return filtered_neighbors{lists[v].first, lists[v].last, local};}
+	bool adjacent(int e1, int e2) const {
+		for (int const * p = lists[e1].first; p != lists[e1].last; p++) {
+			if (*p == global[e2]) return true;
+		}
+
+		return false;
+	}
+
+	void output_adj_list(int v, std::ostream& os) const {
+		os << "vertex " << v << " (host vertex " << global[v] << ") adjacencies: ";
+
+		for (int v2 : neighbors(v)) {
+			os << v2 << " ";
+		}
+
+		os << "\n";
+	}
+};
+
+struct scrambled_neighbors { // the entries of a host adjacency list in the order a permuted_view reads them, translated to view vertex numbers
+	int const * list;
+	int const * local;
+	int degree;
+	int first;	// the position read first
+	int stride; // and the distance between consecutive positions (coprime to the degree, so every position is read once)
+
+	struct iterator {
+		int const * list;
+		int const * local;
+		int degree;
+		int stride;
+		int i;	// how many entries have been read
+		int at; // the position of the next one
+
+		int operator*() const {return local[list[at]];}
+		iterator& operator++() {
+			i++;
+			at += stride;
+			if (at >= degree) at -= degree;
+			return *this;
+		}
+		bool operator!=(iterator const& other) const {return i != other.i;}
+	};
+
+	iterator begin() const {return iterator{list, local, degree, stride, 0, first};}
+	iterator end() const {return iterator{list, local, degree, stride, degree, 0};}
+};
+
+struct permuted_view { // a host graph with its vertices renumbered and (unless order is 0) every adjacency list read in a scrambled order, for running the implementation on many labellings of one graph without copying it
+					   // the renumbering is two host-sized arrays the caller owns; the order is a function of the seed, so it needs no storage at all
+	graph const * host;
+	int n;
+	int e;
+	int const * global; // global[v] is the host vertex numbered v in the view
+	int const * local;	// local[h] is the view number of host vertex h
+	uint64_t order;		// 0 reads every adjacency list in host order; otherwise each vertex's list is read from a position and with a stride picked by hashing order with the vertex
+
+	static uint64_t mix(uint64_t x) { // the splitmix64 finalizer
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ULL;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	scrambled_neighbors scramble(int v) const { // where v's list is read from, and with which stride
+		std::vector<int> const& list = host->adjLists[global[v]];
+		int degree = (int)(list.size());
+		scrambled_neighbors range{list.data(), local, degree, 0, 1};
+		if (order == 0 || degree < 2) return range;
+
+		static constexpr int primes[4] = {1000003, 1299709, 15485863, 2147483629};
+		uint64_t h = mix(order ^ mix((uint64_t)(v)));
+		range.first = (int)(h % (uint64_t)(degree));
+		int p = primes[(h >> 32) & 3];
+		range.stride = p % degree;
+		if (std::gcd(range.stride, degree) != 1) range.stride = 1; // p is prime, so this only happens when the degree is a multiple of it
+		if ((h >> 40) & 1) range.stride = degree - range.stride; // read backwards half of the time
+		return range;
+	}
+
+	int degree(int v) const {return host->degree(global[v]);}
+	int neighbor(int v, int i) const {
+		scrambled_neighbors range = scramble(v);
+		return local[range.list[(int)(((uint64_t)(range.first) + (uint64_t)(range.stride) * (uint64_t)(i)) % (uint64_t)(range.degree))]];
+	}
+	scrambled_neighbors neighbors(int v) const {return scramble(v);}
+	bool adjacent(int e1, int e2) const {return host->adjacent(global[e1], global[e2]);}
+
+	void output_adj_list(int v, std::ostream& os) const {
+		os << "vertex " << v << " (host vertex " << global[v] << ") adjacencies: ";
+
+		for (int v2 : neighbors(v)) {
+			os << v2 << " ";
+		}
+
+		os << "\n";
+	}
+};
+
+struct subgraph_workspace { // the host-sized translation table views need; one view can be bound to a workspace at a time, and binding another invalidates it
+							// binding and unbinding take time proportional to the subset (and the host degrees of its vertices, to count its edges), not to the host, so one workspace can serve any number of subsets in turn
+	graph const& host;
+	std::vector<int> local;					 // -1 for every host vertex outside the bound view
+	std::vector<int> global;				 // the host vertices of the bound view, in order
+	std::vector<member_list> lists;			 // where the bound view reads each of their neighbours from
+	std::vector<int> compact;				 // the entries inside the view of the lists that are mostly outside it, one after another
+	std::vector<std::pair<int, int>> copied; // the local vertices whose lists are in compact, and where each starts
+
+	explicit subgraph_workspace(graph const& host_) : host{host_}, local((size_t)(host_.n), -1) {}
+
+	bool bind(std::vector<int> const& vertices, subgraph_view& out) { // bind the subgraph induced by vertices, failing (and binding nothing) if one is out of range or repeated
+		unbind();
+		for (int h : vertices) {
+			if (h < 0 || h >= host.n || local[h] != -1) {
+				unbind();
+				return false;
+			}
+			local[h] = (int)(global.size());
+			global.push_back(h);
+		}
+
+		int degree_sum = 0;
+		for (int h : global) { // count the edges, keeping the entries inside the view of each list that's mostly outside it
+			std::vector<int> const& list = host.adjLists[h];
+			int start = (int)(compact.size());
+			for (int u : list) {
+				if (local[u] != -1) compact.push_back(u);
+			}
+			int inside = (int)(compact.size()) - start;
+			degree_sum += inside;
+			if (2 * inside >= (int)(list.size())) {
+				compact.resize((size_t)(start));
+				lists.push_back(member_list{list.data(), list.data() + list.size()});
+			} else {
+				lists.push_back(member_list{nullptr, nullptr});
+				copied.emplace_back((int)(lists.size()) - 1, start);
+			}
+		}
+		for (size_t k = 0; k < copied.size(); k++) { // compact has stopped growing, so pointers into it stay valid; each copy ends where the next begins
+			size_t end = k + 1 < copied.size() ? (size_t)(copied[k + 1].second) : compact.size();
+			lists[copied[k].first] = member_list{compact.data() + copied[k].second, compact.data() + end};
+		}
+
+		out = subgraph_view{&host, (int)(global.size()), degree_sum / 2, global.data(), local.data(), lists.data()};
+		return true;
+	}
+
+	void unbind() {
+		for (int h : global) local[h] = -1;
+		global.clear();
+		lists.clear();
+		compact.clear();
+		copied.clear();
+	}
+};
+
+template <typename Graph>
+struct graph_storage { // the containers the implementation keeps its per-vertex state in (and its DFS stacks, which never hold more than one entry per vertex) while it works on a Graph
+					   // vectors by default (allocated with storage_allocator, see page-allocator.hxx); small_graph (see small-graph.hxx) swaps in fixed-size buffers
+	template <typename T>
+	using vertex_array = std::vector<T, storage_allocator<T>>;
+};
+
+template <typename Graph, typename T>
+using vertex_array = typename graph_storage<Graph>::template vertex_array<T>;
+
+template <typename Graph>
+graph copy_graph(Graph const& g) { // a graph with the vertex numbers and adjacency list order of g (of any graph type), leaving out the entries a view skips
+	graph copy{g.n, g.e, {}};
+	copy.reserve(g);
+	for (int v = 0; v < g.n; v++) {
+		for (int i = 0; i < g.degree(v); i++) {
+			int u = g.neighbor(v, i);
+			if (u != -1) copy.adjLists[v].push_back(u);
+		}
+	}
+
+	return copy;
+}
+
 std::istream& operator>>(std::istream& is, graph& g) { // read a graph from an input stream (e.g. file)
+														 // a negative header or an endpoint outside [0, n) sets the stream's failbit and stops reading, instead of writing out of bounds; self-loops and parallel edges are read as they are (see graph-normalization.hxx)
 	g = graph{};
 	is >> g.n >> g.e;
+	if (g.n < 0 || g.e < 0) {
+		is.setstate(std::ios::failbit);
+		return is;
+	}
 
 	g.adjLists.reserve(g.n);
 
@@ -58,7 +298,10 @@ std::istream& operator>>(std::istream& is, graph& g) { // read a graph from an i
 
 	for (int i = 0; i < g.e; i++) { // insert the edges into the graph
 		int endpoint1, endpoint2;
-		is >> endpoint1 >> endpoint2;
+		if (!(is >> endpoint1 >> endpoint2) || endpoint1 < 0 || endpoint1 >= g.n || endpoint2 < 0 || endpoint2 >= g.n) {
+			is.setstate(std::ios::failbit);
+			return is;
+		}
 		g.add_edge(endpoint1, endpoint2);
 	}
 
@@ -80,4 +323,24 @@ std::ostream& operator<<(std::ostream& os, graph const& g) { // output a graph (
 	return os;
 }
 
+std::ostream& operator<<(std::ostream& os, subgraph_view const& g) { // output a view (for debugging purposes)
+	os << "Subgraph with " << g.n << " vertices and " << g.e << " edges:\n";
+
+	for (int i = 0; i < g.n; i++) {
+		g.output_adj_list(i, os);
+	}
+
+	return os;
+}
+
+std::ostream& operator<<(std::ostream& os, permuted_view const& g) { // output a view (for debugging purposes)
+	os << "Permuted graph with " << g.n << " vertices and " << g.e << " edges:\n";
+
+	for (int i = 0; i < g.n; i++) {
+		g.output_adj_list(i, os);
+	}
+
+	return os;
+}
+
 #endif
\ No newline at end of file
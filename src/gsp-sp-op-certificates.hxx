@@ -4,16 +4,20 @@
 #define __GSP_SP_OP_CERTS_HXX__
 
 #include "graph.hxx"
+#include "small-graph.hxx"
+#include "packed-graph.hxx"
 #include "logging.hxx"
 #include "sp-tree.hxx"
 #include "radix_sort.hxx"
 #include <memory>
 #include <vector>
 #include <stack>
+#include <type_traits>
 
 // ---------------- auxiliary functions ----------------
 
-bool trace_path(int end1, int end2, std::vector<edge_t> const& path, graph const& g, std::vector<bool>& seen) { // trace a path, to ensure it is between end1 and end2 (either direction), all its edges are in g, and none of its internal vertices are in seen
+template <typename Graph>
+bool trace_path(int end1, int end2, std::vector<edge_t> const& path, Graph const& g, std::vector<bool>& seen) { // trace a path, to ensure it is between end1 and end2 (either direction), all its edges are in g, and none of its internal vertices are in seen
 	#ifdef __VERBOSE_LOGGING__
 	for (edge_t edge : path) {
 		V_LOG("(" << edge.first << ", " << edge.second << ") ")
@@ -71,7 +75,8 @@ bool trace_path(int end1, int end2, std::vector<edge_t> const& path, graph const
 	return true;
 }
 
-int num_comps_after_removal(graph const& g, int v) { // get number of components of g after v is removed
+template <typename Graph>
+int num_comps_after_removal(Graph const& g, int v) { // get number of components of g after v is removed
 	int retval = 0;
 
 	std::vector<bool> seen((size_t)(g.n), false);
@@ -88,7 +93,7 @@ int num_comps_after_removal(graph const& g, int v) { // get number of components
 			dfs.pop();
 			seen[w] = true;
 
-			for (int u : g.adjLists[w]) {
+			for (int u : g.neighbors(w)) {
 				if (!seen[u] && u != v) {
 					dfs.emplace(u);
 				}
@@ -99,7 +104,8 @@ int num_comps_after_removal(graph const& g, int v) { // get number of components
 	return retval;
 }
 
-bool is_cut_vertex(graph const& g, int v) {
+template <typename Graph>
+bool is_cut_vertex(Graph const& g, int v) {
 	if (num_comps_after_removal(g, v) <= 1) {
 		L_LOG("\n====== AUTH FAILED: " << v << " not a cut vertex ======\n\n")
 		return false;
@@ -113,18 +119,45 @@ bool is_cut_vertex(graph const& g, int v) {
 // ---------------- cert definitions ----------------
 
 struct certificate {
-	bool verified = false;
-	virtual bool authenticate(graph const& g) = 0;
 	virtual ~certificate() {}
+	virtual bool authenticate(graph const& g) = 0; // check the certificate against g, the graph that generated it
+
+	template <typename Graph>
+	bool authenticate_view(Graph const& g) { // the same check against anything else with graph's interface (see graph.hxx), such as a view, a small_graph or a packed_graph
+		if constexpr (std::is_same_v<Graph, graph>) return authenticate(g);
+		else return authenticate_on(g);
+	}
+
+protected:
+	// authenticate_view's hooks, one per graph type; certificate_of checks each one directly, and a certificate deriving from certificate itself only has to provide authenticate, which these fall back to on a copy
+	virtual bool authenticate_on(subgraph_view const& g) {return authenticate(copy_graph(g));}
+	virtual bool authenticate_on(permuted_view const& g) {return authenticate(copy_graph(g));}
+	virtual bool authenticate_on(small_graph<64> const& g) {return authenticate(copy_graph(g));}
+	virtual bool authenticate_on(small_graph<128> const& g) {return authenticate(copy_graph(g));}
+	virtual bool authenticate_on(packed_graph const& g) {return authenticate(copy_graph(g));}
 };
 
-struct negative_cert_K4 : certificate { // K4 subdivision, showing a graph is not GSP, OP, or SP
+template <typename cert>
+struct certificate_of : certificate { // a certificate whose checks are cert::verify, a template run directly on every graph type certificate takes
+	bool authenticate(graph const& g) override {return self().verify(g);}
+
+protected:
+	bool authenticate_on(subgraph_view const& g) override {return self().verify(g);}
+	bool authenticate_on(permuted_view const& g) override {return self().verify(g);}
+	bool authenticate_on(small_graph<64> const& g) override {return self().verify(g);}
+	bool authenticate_on(small_graph<128> const& g) override {return self().verify(g);}
+	bool authenticate_on(packed_graph const& g) override {return self().verify(g);}
+
+private:
+	cert& self() {return static_cast<cert&>(*this);}
+};
+
+struct negative_cert_K4 : certificate_of<negative_cert_K4> { // K4 subdivision, showing a graph is not GSP, OP, or SP
 	int a, b, c, d; // four vertices
 	std::vector<edge_t> ab, ac, ad, bc, bd, cd; // six pairwise internally disjoint paths between them
 
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
-
+	template <typename Graph>
+	bool verify(Graph const& g) {
 		L_LOG("====== AUTHENTICATE K4: terminating vertices a: " << a << ", b: " << b << ", c: " << c << ", d: " << d << " ======\n")
 		if (a == b || b == c || c == d || d == a || a == c || b == d) { // vertices must be distinct
 			L_LOG("====== AUTH FAILED: terminating vertices non-distinct ======\n\n")
@@ -146,18 +179,16 @@ struct negative_cert_K4 : certificate { // K4 subdivision, showing a graph is no
 		if (!trace_path(c, d, cd, g, seen)) return false;
 
 		L_LOG("====== AUTH SUCCESS ======\n\n")
-		verified = true;
 		return true;
 	}
 };
 
-struct negative_cert_K23 : certificate { // K_(2,3) subdivision, showing a graph is not OP
+struct negative_cert_K23 : certificate_of<negative_cert_K23> { // K_(2,3) subdivision, showing a graph is not OP
 	int a, b; // two vertices (making up the independent set of size 2 in K_(2,3))
 	std::vector<edge_t> one, two, three; // three pairwise internally disjoint paths of length at least two between them
 
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
-
+	template <typename Graph>
+	bool verify(Graph const& g) {
 		L_LOG("====== AUTHENTICATE K23: terminating vertices a: " << a << ", b: " << b << " ======\n")
 
 		if (a == b) { // vertices must be distinct
@@ -190,17 +221,16 @@ struct negative_cert_K23 : certificate { // K_(2,3) subdivision, showing a graph
 
 		L_LOG("====== AUTH SUCCESS ======\n\n")
 
-		verified = true;
 		return true;
 	}
 };
 
-struct negative_cert_T4 : certificate { // a theta_(4) subdivision with the top and bottom of the "theta" being two cut vertices of a graph, showing the graph is not SP (but may still be GSP)
+struct negative_cert_T4 : certificate_of<negative_cert_T4> { // a theta_(4) subdivision with the top and bottom of the "theta" being two cut vertices of a graph, showing the graph is not SP (but may still be GSP)
 	int c1, c2, a, b; // four vertices, with c1 and c2 cut vertices
 	std::vector<edge_t> c1a, c1b, c2a, c2b, ab; // five pairwise internally disjoint paths between them (the path between c1 and c2 is not part of theta_(4))
 
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
+	template <typename Graph>
+	bool verify(Graph const& g) {
 		L_LOG("====== AUTHENTICATE T4: terminating vertices a: " << a << ", b: " << b << ", c1: " << c1 << ", c2: " << c2 << " ======\n")
 
 		if (a == b || a == c1 || a == c2 || b == c1 || b == c2 || c1 == c2) { // vertices must be distinct
@@ -228,16 +258,15 @@ struct negative_cert_T4 : certificate { // a theta_(4) subdivision with the top
 
 		L_LOG("====== AUTH SUCCESS ======\n\n")
 
-		verified = true;
 		return true;
 	}
 };
 
-struct negative_cert_tri_comp_cut : certificate { // a cut vertex that divides a graph into three or more components, showing the graph is not SP (but may still be GSP)
+struct negative_cert_tri_comp_cut : certificate_of<negative_cert_tri_comp_cut> { // a cut vertex that divides a graph into three or more components, showing the graph is not SP (but may still be GSP)
 	int v; // the cut vertex
 
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
+	template <typename Graph>
+	bool verify(Graph const& g) {
 		L_LOG("====== AUTHENTICATE THREE-COMPONENT CUT VERTEX: " << v << " ======\n")
 
 		int comps = num_comps_after_removal(g, v);
@@ -250,16 +279,15 @@ struct negative_cert_tri_comp_cut : certificate { // a cut vertex that divides a
 		N_LOG(comps << " comps after removal\n")
 		L_LOG("====== AUTH SUCCESS ======\n\n")
 
-		verified = true;
 		return true;
 	}
 };
 
-struct negative_cert_tri_cut_comp : certificate { // three cut vertices which are part of a single biconnected component of a graph, showing the graph is not SP (but may still be GSP)
+struct negative_cert_tri_cut_comp : certificate_of<negative_cert_tri_cut_comp> { // three cut vertices which are part of a single biconnected component of a graph, showing the graph is not SP (but may still be GSP)
 	int c1, c2, c3; // the three cut vertices
 
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
+	template <typename Graph>
+	bool verify(Graph const& g) {
 		L_LOG("====== AUTHENTICATE BICOMP WITH THREE CUT VERTICES: cut vertices " << c1 << ", " << c2 << ", " << c3 << " ======\n")
 		N_LOG("verify c1 cut vertex: ") // they all need to be cut vertices
 		if (!is_cut_vertex(g, c1)) return false;
@@ -287,7 +315,11 @@ struct negative_cert_tri_cut_comp : certificate { // three cut vertices which ar
 		while (!dfs.empty()) {
 			std::pair<int, int> p = dfs.top();
 			int w = p.first;
-			int u = g.adjLists[p.first][p.second];
+			int u = g.neighbor(p.first, p.second);
+			if (u == -1) { // skip entries outside a subgraph_view
+				if (++dfs.top().second >= g.degree(p.first)) dfs.pop();
+				continue;
+			}
 
 			if (dfs_no[u] == 0) { // recurse if we haven't seen u
 				dfs.push(std::pair{u, 0});
@@ -315,8 +347,6 @@ struct negative_cert_tri_cut_comp : certificate { // three cut vertices which ar
 					if (seen[0] && seen[1] && seen[2]) { // if this bicomp contains all three of the vertices, we're good
 						N_LOG("vertices belong to one biconnected component...\n")	
 						L_LOG("====== AUTH SUCCESS ======\n\n")
-
-						verified = true;
 						return true;
 					}
 				}
@@ -328,7 +358,7 @@ struct negative_cert_tri_cut_comp : certificate { // three cut vertices which ar
 				if (dfs_no[u] < low[w]) low[w] = dfs_no[u]; // update low, if the outgoing back edge has a lower DFS number at its sink then it follows that w has at most that value as its low, since w is trivially a descendant of w
 			}
 
-			if ((size_t)(++dfs.top().second) >= g.adjLists[p.first].size()) { // we are done processing the adjacency list of w and are backing up to the parent
+			if (++dfs.top().second >= g.degree(p.first)) { // we are done processing the adjacency list of w and are backing up to the parent
 				dfs.pop(); // end the recursive call
 			}
 		}
@@ -338,169 +368,98 @@ struct negative_cert_tri_cut_comp : certificate { // three cut vertices which ar
 	}
 };
 
-struct positive_cert_gsp : certificate { // SP decomposition tree showing a graph is GSP or SP
-	sp_tree decomposition;
-	bool is_sp; // mark true if this is an SP tree (no dangling compositions allowed)
-
-	bool authenticate(graph const& g) override {
-		if (verified) return true; // don't redo the work if we've already verified this certificate
-
-		std::vector<int> n_src((size_t)(g.n), 0); 	  	 // n_src[i] is the number of SP subgraphs we have with source at vertex i
-		std::vector<int> n_sink((size_t)(g.n), 0); 	  	 // n_sink[i] is the number of SP subgraphs we have with sink at vertex i	
-		std::vector<bool> no_edge((size_t)(g.n), false); // no_edge[i] is whether we've already merged vertex i into an SP subgraph, preventing any other edges incident on it
-		bool swap = false; 	  // keeps track of whether source and sink of an SP subgraph should be swapped (in an antiparallel composition)
+template <typename Graph>
+struct sp_decomposition_checker { // the checks that show a decomposition tree builds exactly G, made one node at a time in post-order
+								  // the paper walks the tree top-down with a "swap" switch for antiparallel nodes, but every check it makes is symmetric in the source and sink of a swapped subtree
+								  // so here everything is checked against the sources and sinks as they are stored, and instead of separate counts of SP subgraphs with source and with sink at each vertex we keep one count of SP subgraphs ending at each vertex
+								  // a series composition needs exactly two subgraphs ending at its middle vertex, which is the same as needing one source and one sink there (each child contributes one of them), so this is equivalent to the swap version
+								  // this is shared by positive_cert_gsp::authenticate (on a flat_sp_tree) and the streaming verifier in gsp-sp-op-serialization.hxx (straight from a file)
+	Graph const& g;
+	bool is_sp;
+	std::vector<int> n_end;		 // n_end[i] is the number of SP subgraphs we have with source or sink at vertex i
+	std::vector<bool> no_edge;	 // no_edge[i] is whether we've already merged vertex i into an SP subgraph, preventing any other edges incident on it
+	graph g2;					 // graph we will construct
 
-		graph g2{}; // graph we will construct
+	sp_decomposition_checker(Graph const& g_, bool is_sp_) : g{g_}, is_sp{is_sp_}, n_end((size_t)(g_.n), 0), no_edge((size_t)(g_.n), false), g2{} {
 		g2.reserve(g); // reserve edge space
-		std::stack<std::pair<sp_tree_node *, int>> hist; // my implementation performs an iterative traversal of the SP tree to prevent stack overflow on exceptionally large graphs
-														 // first element of each pair is the node in the recursive stack, second is our progress in pushing its children onto the stack (needed so I can restore swap after backtracking into an antiparallel node from its right child and perform the traversal in post-order)
-		L_LOG("====== AUTHENTICATE " << (is_sp ? "SP" : "GSP") << " DECOMPOSITION TREE ======\n")
-		if (!decomposition.root) { // the tree can't just be all a dream
-			L_LOG("====== AUTH FAILED: decomposition tree does not exist ======\n\n")
+	}
+
+	bool edge(int source, int sink) { // leaf for the edge (source, sink)
+		if (source < 0 || source >= g.n || sink < 0 || sink >= g.n) {
+			L_LOG("====== AUTH FAILED: edge node " << source << "e" << sink << " is not an edge between vertices of G ======\n\n")
 			return false;
 		}
 
-		hist.emplace(decomposition.root, 0); // initialize traversal
-
-		while (!hist.empty()) {
-			sp_tree_node * curr = hist.top().first;
-			V_LOG("traversal: " << *curr << ", phase: " << hist.top().second << "\n")
-			int source = (swap ? curr->sink : curr->source);
-			int sink = (swap ? curr->source : curr->sink);
-
-			if (hist.top().second == 0) { // first time looking at this node
-				if (!(curr->l) || !(curr->r)) { // if this is a leaf node (has one or more null children), visit it and pop it off the stack
-					if (curr->l || curr->r) { // can't have one child on a decomp tree
-						L_LOG("====== AUTH FAILED: node " << *curr << " malformed (one child) ======\n\n")
-						return false;
-					}
-
-					if (curr->comp != c_type::edge) { // can't have non-edge leaf
-						L_LOG("====== AUTH FAILED: node " << *curr << " malformed (leaf, but not an edge) ======\n\n")
-						return false;
-					}
+		if (no_edge[source] || no_edge[sink]) { // can't have this edge incident to a vertex which has already been merged into an SP subgraph
+			L_LOG("====== AUTH FAILED: edge node " << source << "e" << sink << " is incident on an vertex already merged into a series SP subgraph ======\n\n")
+			return false;
+		}
 
-					if (no_edge[source] || no_edge[sink]) { // can't have this edge incident to a vertex which has already been merged into an SP subgraph
-						L_LOG("====== AUTH FAILED: edge node " << *curr << " is incident on an vertex already merged into a series SP subgraph ======\n\n")
-						return false;
-					}
+		g2.add_edge(source, sink); // add this edge to our adj lists
+		n_end[source]++; // update SP subgraph count
+		n_end[sink]++;
+		return true;
+	}
 
-					g2.add_edge(source, sink); // add this edge to our adj lists
-					n_src[source]++; // update SP subgraph count
-					n_sink[sink]++;
-					hist.pop(); // finish visit
-				} else { // internal node, don't visit it yet and push its children so the traversal is post-order and mark it so we can visit it on the way back
-					if (curr->comp == c_type::antiparallel) swap = !swap; // if we're entering a marked (antiparallel) node's right child, flip the swap switch so we know to swap the source and sink of all descendants
-																		  // the order of the trees is important; the next one we'll look at is the right subtree, which is the swapped one, the left one isn't swapped
-					hist.top().second++; // increment progress in processing this node
-					hist.emplace(curr->r, 0);
+	bool compose(c_type comp, int source, int sink, edge_t l, edge_t r) { // composed node (source, sink) whose children are l and r (as (source, sink) pairs)
+		switch (comp) {
+			case c_type::edge: // internal nodes can't be edges
+				L_LOG("====== AUTH FAILED: node " << source << "e" << sink << " malformed (edge, but internal) ======\n\n")
+				return false;
+			case c_type::series:
+				if (l.first != source || r.second != sink || l.second != r.first) {
+					L_LOG("====== AUTH FAILED: node " << source << "S" << sink << " malformed (series children source/sink mismatch) ======\n\n")
+					return false;
 				}
-			} else if (hist.top().second == 1) { // push left child the second time we see a node
-				if (curr->comp == c_type::antiparallel) swap = !swap; // if we entered an antiparallel node from its right child, restore the swap switch to its original value
-				hist.top().second++; // increment progress in processing this node
-				hist.emplace(curr->l, 0);
-			} else { // once processed both children, we can process the parent node
-				int lsource = (swap ? curr->r->sink : curr->l->source); // swap the necessary sources and sinks if required
-				int lsink = (swap ? curr->r->source : curr->l->sink);   // note we also need to swap left and right children iff swap = true, otherwise e.g {aXb}aSc{bXc} would become {bXa}cSa{cXb}, which is malformed
-				int rsource = (swap ? curr->l->sink : curr->r->source);
-				int rsink = (swap ? curr->l->source : curr->r->sink);
-
-				switch (curr->comp) {
-					case c_type::edge: // if it's an edge node, it's malformed; internal nodes can't be edges
-						L_LOG("====== AUTH FAILED: node " << *curr << " malformed (edge, but internal) ======\n\n")
-						return false;
-					case c_type::series:
-						if (lsource != source || rsink != sink || lsink != rsource) {
-							L_LOG("====== AUTH FAILED: node " << *curr << " malformed (series children source/sink mismatch) ======\n\n")
-							return false;
-						}
-
-						if (n_src[lsink] != 1 || n_sink[lsink] != 1) { // can't have pending SP subgraphs at this vertex, otherwise we won't be able to merge them
-							L_LOG("====== AUTH FAILED: series node " << *curr << " has incident edges on its middle vertex " << lsink << " which cannot be merged into it ======\n\n")
-							return false;
-						}
-
-						V_LOG("BLOCKING: " << lsink << "\n")
-						no_edge[lsink] = true; // the middle vertex can't have any edges merged into it anymore
-						n_src[lsink]--; // update SP subgraph counts
-						n_sink[lsink]--;
-						break;
-					case c_type::parallel:
-						if (lsource != source || rsource != source || lsink != sink || rsink != sink) {
-							L_LOG("====== AUTH FAILED: node " << *curr << " malformed (parallel children source/sink mismatch) ======\n\n")
-							return false;
-						}
-
-						n_src[source]--; // update SP subgraph counts
-						n_sink[sink]--;
-						break;
-					case c_type::antiparallel:
-						if (swap) { // if we're swapped it's the left child who is inverted instead of the right one
-							if (lsource != sink || rsource != source || lsink != source || rsink != sink) {
-								L_LOG("====== AUTH FAILED: node " << *curr << " malformed (antiparallel children source/sink mismatch) ======\n\n")
-								return false;
-							}
-						} else {
-							if (lsource != source || rsource != sink || lsink != sink || rsink != source) {
-								L_LOG("====== AUTH FAILED: node " << *curr << " malformed (antiparallel children source/sink mismatch) ======\n\n")
-								return false;
-							}
-						}
 
-						n_src[source]--; // update SP subgraph counts (the right child was swapped into having the correct source/sink orientation, so this step is identical to the parallel one)
-						n_sink[sink]--;
-						break;
-					case c_type::dangling:
-						if (is_sp) { // can't have dangling compositions in an SP decomposition, just a GSP one
-							L_LOG("====== AUTH FAILED: illegal dangling composition in SP decomposition tree ======\n\n")
-							return false;
-						}
+				if (n_end[l.second] != 2) { // can't have pending SP subgraphs at this vertex, otherwise we won't be able to merge them
+					L_LOG("====== AUTH FAILED: series node " << source << "S" << sink << " has incident edges on its middle vertex " << l.second << " which cannot be merged into it ======\n\n")
+					return false;
+				}
 
-						if (swap) { // if we're swapped it's the left child who is dangling instead of the right one
-									// the swap switch sort of messes with dangling compositions; if we're swapped and a dangling happens the dangling will be connected to the wrong edge 
-									// for example, if there is (v, w)S((w, u)D(w, w')), it will become after a swap ((w', w)D(u, w))S(w, v), after which the dangling should be attached to (w, v) and not be swapped but it remains attached to (u, w) and swapped)
-							if (rsource != source || rsink != sink || lsink != sink) {
-								L_LOG("====== AUTH FAILED: node " << *curr << " malformed (dangling children source/sink mismatch) ======\n\n")
-								return false;
-							}
-						} else {
-							if (lsource != source || lsink != sink || rsource != source) {
-								L_LOG("====== AUTH FAILED: node " << *curr << " malformed (dangling children source/sink mismatch) ======\n\n")
-								return false;
-							}
-						}
+				no_edge[l.second] = true; // merge middle vertex into SP subgraph
+				n_end[l.second] -= 2;
+				return true;
+			case c_type::parallel:
+			case c_type::antiparallel: // antiparallel is the same, with the right child flipped around
+				if (l != edge_t{source, sink} || r != (comp == c_type::parallel ? edge_t{source, sink} : edge_t{sink, source})) {
+					L_LOG("====== AUTH FAILED: node " << source << c_type_char(comp) << sink << " malformed (" << (comp == c_type::parallel ? "parallel" : "antiparallel") << " children source/sink mismatch) ======\n\n")
+					return false;
+				}
 
-						if (swap) {
-							n_src[lsource]--; // update SP subgraph counts (we need special handling if the swap switch is active per the reasoning above; the left child is dangling, and its source and sink will be erroneously switched around)
-							n_sink[sink]--;
-						} else {
-							n_src[source]--; // update SP subgraph counts
-							n_sink[rsink]--; // this instruction is not in the paper; the paper only suggests decrementing the source count for the source of the parent node
-											 // the paper also suggests keeping track of whether every vertex is a cut vertex or a sink of an SP subgraph of a biconnected component, so the expected final sink counts can be determined (the sink count should be 1 iff the vertex is a sink and not a cut vertex)
-											 // doing all this is a lot of other stuff to keep track of in our certificate, but this single instruction in fact avoids all of this work, and makes it so you just need to check, given a root node of the decomp tree rXt, if the n_src for r is 1 and the n_sink for t is 1 (and of course that all the other source/sink numbers are 0)
-											 // the correctness should be obvious enough by induction on the number of biconnected components processed in the queue produced by GSP-SP-OP
-						}
+				n_end[source]--; // two SP subgraphs become one
+				n_end[sink]--;
+				return true;
+			case c_type::dangling:
+				if (is_sp) { // can't have dangling compositions in an SP decomposition, just a GSP one
+					L_LOG("====== AUTH FAILED: illegal dangling composition in SP decomposition tree ======\n\n")
+					return false;
+				}
 
-						break;
+				if (l != edge_t{source, sink} || r.first != source) {
+					L_LOG("====== AUTH FAILED: node " << source << "D" << sink << " malformed (dangling children source/sink mismatch) ======\n\n")
+					return false;
 				}
 
-				hist.pop(); // we're done with this node (pushed both children and processed parent)
-			}
+				n_end[source]--; // update SP subgraph counts
+				n_end[r.second]--; // this instruction is not in the paper; the paper only suggests decrementing the source count for the source of the parent node
+								   // the paper also suggests keeping track of whether every vertex is a cut vertex or a sink of an SP subgraph of a biconnected component, so the expected final sink counts can be determined (the sink count should be 1 iff the vertex is a sink and not a cut vertex)
+								   // doing all this is a lot of other stuff to keep track of in our certificate, but this single instruction in fact avoids all of this work, and makes it so you just need to check, given a root node of the decomp tree rXt, that the counts for r and t are 1 (and of course that all the other counts are 0)
+								   // the correctness should be obvious enough by induction on the number of biconnected components processed in the queue produced by GSP-SP-OP
+				return true;
 		}
+		return false;
+	}
 
+	bool finish(int source, int sink) { // after the root (source, sink), check the tree is connected and produces exactly G
 		N_LOG("decomposition tree well-formed...\n")
-		n_src[decomposition.root->source]--; // uncount the source and sink of the final SP subgraph at the root of the tree; after this point n_src and n_sink should be 0 everywhere
-		n_sink[decomposition.root->sink]--;
+		n_end[source]--; // uncount the source and sink of the final SP subgraph at the root of the tree; after this point n_end should be 0 everywhere
+		n_end[sink]--;
 
 		bool failed = false;
 		for (int i = 0; i < g.n; i++) {
-			if (n_src[i] != 0) { // can't have other SP subgraphs than the root one which are part of the decomposition tree
-				N_LOG("OH NO: disconnected SP subgraph sourced at vertex " << i << "\n")
-				failed = true;
-			}
-			
-			if (n_sink[i] != 0) {
-				N_LOG("OH NO: disconnected SP subgraph sinked at vertex " << i << "\n")
+			if (n_end[i] != 0) { // can't have other SP subgraphs than the root one which are part of the decomposition tree
+				N_LOG("OH NO: disconnected SP subgraph ending at vertex " << i << "\n")
 				failed = true;
 			}
 		}
@@ -513,7 +472,9 @@ struct positive_cert_gsp : certificate { // SP decomposition tree showing a grap
 		N_LOG("decomposition tree connected...\n")
 
 		for (size_t i = 0; i < g2.adjLists.size(); i++) { // radix sort adjacency lists for comparison
-			std::vector<int> l1 = g.adjLists[i];
+			std::vector<int> l1;
+			l1.reserve(g2.adjLists[i].size());
+			for (int u : g.neighbors((int)(i))) l1.push_back(u);
 			radix_sort(l1);
 			radix_sort(g2.adjLists[i]);
 			if (l1 != g2.adjLists[i]) { // the adjacency lists must be the same
@@ -521,33 +482,70 @@ struct positive_cert_gsp : certificate { // SP decomposition tree showing a grap
 
 				#ifdef __LOGGING__
 				N_LOG("ORIGINAL GRAPH: ")
-				g2.output_adj_list(i, std::cout);
+				g.output_adj_list(i, std::cout);
 				N_LOG("PRODUCED GRAPH: ")
 				g2.output_adj_list(i, std::cout);
 				#endif
 
 				L_LOG("======================================================================\n\n")
-				return false;				
+				return false;
 			}
 		}
 
 		N_LOG("decomposition tree produces graph identical to G...\n")
 		L_LOG("====== AUTH SUCCESS ======\n\n")
-
-		verified = true;
 		return true;
 	}
 };
 
-struct positive_cert_op : certificate { // external boundary of an outerplanar embedding showing a graph is OP
+template <typename Graph>
+bool authenticate_decomposition(flat_sp_tree const& t, Graph const& g, bool is_sp) { // authenticate a flattened decomposition tree with a single forward scan (children always come before their parents)
+	L_LOG("====== AUTHENTICATE " << (is_sp ? "SP" : "GSP") << " DECOMPOSITION TREE ======\n")
+	if (t.empty()) { // the tree can't just be all a dream
+		L_LOG("====== AUTH FAILED: decomposition tree does not exist ======\n\n")
+		return false;
+	}
+
+	if (!t.well_formed || !t.consistent()) { // every internal node needs two children, and every leaf needs to be an edge
+		L_LOG("====== AUTH FAILED: decomposition tree malformed (not a binary tree with edges at the leaves) ======\n\n")
+		return false;
+	}
+
+	sp_decomposition_checker check{g, is_sp};
+	for (int i = 0; i <= t.root(); i++) {
+		flat_sp_node const& node = t.nodes[i];
+		V_LOG("scan: " << node.source << c_type_char(node.comp) << node.sink << "\n")
+
+		if (node.comp == c_type::edge) {
+			if (!check.edge(node.source, node.sink)) return false;
+		} else {
+			flat_sp_node const& l = t.nodes[t.left(i)];
+			flat_sp_node const& r = t.nodes[t.right(i)];
+			if (!check.compose(node.comp, node.source, node.sink, {l.source, l.sink}, {r.source, r.sink})) return false;
+		}
+	}
+
+	return check.finish(t.nodes.back().source, t.nodes.back().sink);
+}
+
+struct positive_cert_gsp : certificate_of<positive_cert_gsp> { // SP decomposition tree showing a graph is GSP or SP
+	flat_sp_tree decomposition; // frozen once when the certificate is built, so authentication, the DPs, the exporters and the serializer all just scan it
+	bool is_sp; // mark true if this is an SP tree (no dangling compositions allowed)
+
+	template <typename Graph>
+	bool verify(Graph const& g) { // authenticate the tree with a linear scan (see sp_decomposition_checker)
+		return authenticate_decomposition(decomposition, g, is_sp);
+	}
+};
+
+struct positive_cert_op : certificate_of<positive_cert_op> { // external boundary of an outerplanar embedding showing a graph is OP
 	std::vector<std::vector<edge_t>> boundaries; // boundaries[i] is the external boundary of the ith biconnected component (in the order they were produced, forming a rooted tree of biconnected components), and the union of all the boundaries is the exterior boundary of G
 
-	bool authenticate(graph const& g) override { // NOTE: the paper gives no guidance on how to authenticate the exterior boundaries for non-biconnected outerplanar graphs, so I have filled in the details a bit here
+	template <typename Graph>
+	bool verify(Graph const& g) { // NOTE: the paper gives no guidance on how to authenticate the exterior boundaries for non-biconnected outerplanar graphs, so I have filled in the details a bit here
 												 // I authenticate each biconnected component's exterior boundary separately using the method given in the paper, and keep track of a few additional things to ensure they are actually biconnected components (i.e. there are no edges for which there is no component both endpoints belong to, and there are no cycles of "biconnected components")
 												 // the algorithm I use is a bit complicated, and I have not proven its correctness or time complexity, but I can write up a proof of correctness if you want (it should be relatively obvious, at least around as obvious as the other things marked as "obvious" and left unproven in the paper)
 
-		if (verified) return true; // don't redo the work if we've already verified this certificate
-
 		std::vector<int> comp_parent(boundaries.size(), -1);   // comp_parent[i] is the parent of the ith biconnected component in the tree of biconnected components
 									   					   	   // I use this to ensure there are no errant edges between one biconnected component and another
 		std::vector<int> root_vertices(boundaries.size(), -1); // root_vertices[i] is the root vertex of the ith biconnected component (as defined in the paper)
@@ -647,11 +645,11 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 					e.second = temp;
 				}
 				bool edge_in_g = false;
-				for (int u : g.adjLists[e.second]) { // ensure that all the outgoing edges of the single non-root vertex are either in this component or going to an immediate child component whose root vertex is this vertex
+				for (int u : g.neighbors(e.second)) { // ensure that all the outgoing edges of the single non-root vertex are either in this component or going to an immediate child component whose root vertex is this vertex
 													 // if there are any edges which don't do this, then those edges do not have any single biconnected component they belong to and are illegal
 					if (u == root) {
 						edge_in_g = true;
-					} else if (comp_parent[component[u]] != cnum || e.second != root_vertices[component[u]]) {
+					} else if (component[u] == -1 || comp_parent[component[u]] != cnum || e.second != root_vertices[component[u]]) { // (a vertex in no boundary at all has no component)
 						L_LOG("====== AUTH FAILED: edge (" << u << ", " << e.second << ") does not belong to any bicomp ======\n\n")
 						return false;
 					}
@@ -774,7 +772,7 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 						k4.ac.emplace_back(k4.a, k4.c); // both interlacing ears are trivial
 						k4.bd.emplace_back(k4.b, k4.d);
 
-						if (k4.authenticate(g)) { // auth our K4 to know for sure our auth of the K23 failed due to the main code for outerplanar detection being wrong
+						if (k4.verify(g)) { // auth our K4 to know for sure our auth of the K23 failed due to the main code for outerplanar detection being wrong
 							L_LOG("====== AUTH OF K23 FAILED: ear (" << w << ", " << vertex_stacks[w].top().first << ") interlaces with ear (" << seq_source << ", " << k4.d << ") ======\n\n")
 							return false;
 						} else { // if we can't even generate a K4, then we don't even know if it was the main code or this authentication code which is wrong
@@ -786,7 +784,7 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 
 				if (w != root) { // don't loop over children of root, that would not be O(|E|) time but O(|V||E|) (since if there are multiple bicomps rooted at the same vertex, we'd go through the adjacency list of the vertex once per rooted bicomp, leading to very bad performance on, say, K_(1, 100000))
 								 // fortunately, we can get away with not doing so; every other vertex in this bicomp will send their back-edges to the root, and when we process the parent bicomp we will go through the adjacencies of the root of this bicomp exactly once for a nice O(|E|) time
-					for (int u : g.adjLists[w]) { // loop over children in G
+					for (int u : g.neighbors(w)) { // loop over children in G
 						if (u == cycle_adjs[w][0]) { // if it's on the cycle, don't process it and instead mark the relevant edge in the cycle as seen
 							seen[dfs_path.size() - 2] = true;
 						} else if (u == cycle_adjs[w][1]) {
@@ -798,7 +796,7 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 								vertex_stacks[u].emplace(w, -1); // instantly push this entry ending at w onto the relevant vertex stack (we already know it's the losing ear, since the big cycle is always the winning ear)
 								
 								if (dfs_no[u] < dfs_no[earliest_outgoing]) earliest_outgoing = u; // there is a new earliest outgoing
-							} else if (comp_parent[component[u]] != cnum || w != root_vertices[component[u]]) {		   // otherwise, u isn't in this biconnected component
+							} else if (component[u] == -1 || comp_parent[component[u]] != cnum || w != root_vertices[component[u]]) {		   // otherwise, u isn't in this biconnected component
 																													   // if the parent of the bicomp it's in isn't this bicomp, then this edge does not belong to any bicomp (since even if w is the root vertex of a child bicomp the child bicomp can't contain u)
 																													   // similarly, if w is not the root vertex of the component it's in, the edge doesn't belong (since w would then only be in this bicomp and no other bicomp, and u is not in this bicomp)
 								L_LOG("====== AUTH FAILED: edge (" << w << ", " << u << ") does not belong to any bicomp ======\n\n")
@@ -833,9 +831,9 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 
 		N_LOG((boundaries.size() > 1 ? "all bicomp boundaries" : "bicomp boundary") << " good... final root left\n")
 
-		for (int u : g.adjLists[root_vertices[boundaries.size() - 1]]) { // check the root of the final bicomp for errant edges
+		for (int u : g.neighbors(root_vertices[boundaries.size() - 1])) { // check the root of the final bicomp for errant edges
 			if ((size_t)(component[u]) != boundaries.size() - 1 && 
-			   ((size_t)(comp_parent[component[u]]) != boundaries.size() - 1 || root_vertices[boundaries.size() - 1] != root_vertices[component[u]])) { // errant edge
+			   (component[u] == -1 || (size_t)(comp_parent[component[u]]) != boundaries.size() - 1 || root_vertices[boundaries.size() - 1] != root_vertices[component[u]])) { // errant edge
 				L_LOG("====== AUTH FAILED: edge (" << u << ", " << root_vertices[boundaries.size() - 1] << ") does not belong to any bicomp ======\n\n")
 				return false;
 			}
@@ -853,7 +851,6 @@ struct positive_cert_op : certificate { // external boundary of an outerplanar e
 		N_LOG((boundaries.size() > 1 ? "bicomps span" : "bicomp spans") << " whole graph...\n")
 		L_LOG("====== AUTH SUCCESS ======\n\n")
 
-		verified = true;
 		return true;
 	}
 };
@@ -866,7 +863,8 @@ struct gsp_sp_op_result {
 	std::shared_ptr<certificate> sp_reason;
 	std::shared_ptr<certificate> op_reason;
 
-	bool authenticate(graph const& g) const {
+	template <typename Graph>
+	bool authenticate(Graph const& g) const {
 		//int useless = 1;
 		L_LOG("================== AUTHENTICATING GSP-SP-OP RESULT ==================\n") 
 		V_LOG(g)
@@ -877,19 +875,19 @@ struct gsp_sp_op_result {
 			L_LOG("ERROR: gsp_reason not given")
 			return false;
 		}
-		if (!gsp_reason->authenticate(g)) return false;
+		if (!gsp_reason->authenticate_view(g)) return false;
 
 		if (!sp_reason) {
 			L_LOG("ERROR: sp_reason not given")
 			return false;
 		}
-		if (!sp_reason->authenticate(g)) return false;
+		if (sp_reason != gsp_reason && !sp_reason->authenticate_view(g)) return false; // a reason shared with one already checked needn't be checked again
 
 		if (!op_reason) {
 			L_LOG("ERROR: op_reason not given")
 			return false;
 		}
-		if (!op_reason->authenticate(g)) return false;
+		if (op_reason != gsp_reason && op_reason != sp_reason && !op_reason->authenticate_view(g)) return false;
 
 		L_LOG("this graph is " << (is_gsp ? "" : "NOT ") << "GSP, " << (is_sp ? "" : "NOT ") << "SP, and " << (is_op ? "" : "NOT ") << "OP\n")
 		return true;
@@ -0,0 +1,486 @@
+// this file contains a compact binary format for gsp_sp_op_results and their certificates, so they can be shipped somewhere else and authenticated later
+// it also contains a verifier which authenticates a result straight out of a (memory-mapped) certificate file, streaming the decomposition tree through the same checks as positive_cert_gsp::authenticate instead of rebuilding it
+//
+// the format is as follows (every integer is an unsigned LEB128 varint unless otherwise stated):
+// * the 4 bytes "GSPC", followed by a version byte (currently 1)
+// * a flags byte: bit 0 is is_gsp, bit 1 is is_sp, bit 2 is is_op
+// * the number of distinct certificates k, followed by k certificate records (the reasons may share certificates, so each one is only written once)
+// * three indices into the certificate records, for gsp_reason, sp_reason, and op_reason respectively
+//
+// a certificate record is a type byte followed by its payload:
+// * 1 (K4): a, b, c, d, then the paths ab, ac, ad, bc, bd, cd
+// * 2 (K23): a, b, then the paths one, two, three
+// * 3 (T4): c1, c2, a, b, then the paths c1a, c1b, c2a, c2b, ab
+// * 4 (tri-comp-cut): v
+// * 5 (tri-cut-comp): c1, c2, c3
+// * 6 (decomposition tree): an is_sp byte, the number of nodes m, then m (comp, source, sink) records with comp a single byte (c_type), in post-order (left subtree, right subtree, node)
+// * 7 (exterior boundary): the number of bicomps, then for each one the number of edges followed by the endpoints of each edge
+// a path is written as its number of vertices followed by the vertices in order (so every interior vertex is only written once, instead of twice like in a std::vector<edge_t>)
+
+#ifndef __GSP_SP_OP_SERIALIZATION_HXX__
+#define __GSP_SP_OP_SERIALIZATION_HXX__
+
+#include "graph.hxx"
+#include "logging.hxx"
+#include "sp-tree.hxx"
+#include "gsp-sp-op-certificates.hxx"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define __GSP_HAVE_MMAP__
+#endif
+
+enum class cert_tag : unsigned char {
+	K4 = 1, K23 = 2, T4 = 3, tri_comp_cut = 4, tri_cut_comp = 5, gsp = 6, op = 7
+};
+
+// ---------------- byte-level encoding ----------------
+
+struct cert_writer {
+	std::vector<unsigned char> bytes;
+
+	void byte(unsigned char b) { bytes.push_back(b); }
+
+	void varint(uint64_t x) {
+		while (x >= 0x80) {
+			bytes.push_back((unsigned char)(x | 0x80));
+			x >>= 7;
+		}
+		bytes.push_back((unsigned char)(x));
+	}
+
+	void vertex(int v) { varint((uint64_t)(uint32_t)(v)); } // vertices are never negative in a finished certificate, but if one somehow is it will just fail the range check when read back
+
+	bool path(std::vector<edge_t> const& p) { // write a path as a vertex sequence; fails if the edges don't chain together (the engine never produces such a path, and it couldn't authenticate anyway)
+		if (p.empty()) {
+			varint(0);
+			return true;
+		}
+
+		varint(p.size() + 1);
+		vertex(p[0].first);
+		for (size_t i = 0; i < p.size(); i++) {
+			if (i > 0 && p[i].first != p[i - 1].second) return false;
+			vertex(p[i].second);
+		}
+		return true;
+	}
+};
+
+struct cert_reader { // bounds-checked reader over a byte range; once anything is out of bounds ok is false and every later read returns 0
+	unsigned char const * pos;
+	unsigned char const * end;
+	bool ok = true;
+
+	cert_reader(unsigned char const * data, size_t size) : pos{data}, end{data + size} {}
+
+	unsigned char byte() {
+		if (pos >= end) {
+			ok = false;
+			return 0;
+		}
+		return *pos++;
+	}
+
+	uint64_t varint() {
+		uint64_t x = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			unsigned char b = byte();
+			x |= (uint64_t)(b & 0x7f) << shift;
+			if (!(b & 0x80)) return x;
+		}
+		ok = false;
+		return 0;
+	}
+
+	int vertex(int n) { // read a vertex, which must be in [0, n)
+		uint64_t v = varint();
+		if (v >= (uint64_t)(n)) {
+			ok = false;
+			return 0;
+		}
+		return (int)(v);
+	}
+
+	size_t count(size_t max) { // read a length, which can't be more than max (this keeps a corrupt file from making us allocate something enormous)
+		uint64_t c = varint();
+		if (c > max) {
+			ok = false;
+			return 0;
+		}
+		return (size_t)(c);
+	}
+
+	std::vector<edge_t> path(int n) {
+		std::vector<edge_t> p;
+		size_t len = count(remaining());
+		if (len == 1) ok = false; // a single vertex isn't a path
+		if (!ok || len == 0) return p;
+
+		p.reserve(len - 1);
+		int prev = vertex(n);
+		for (size_t i = 1; i < len && ok; i++) {
+			int v = vertex(n);
+			p.emplace_back(prev, v);
+			prev = v;
+		}
+		return p;
+	}
+
+	size_t remaining() const { return (size_t)(end - pos); } // every encoded value takes at least a byte, so nothing can have more elements than this
+};
+
+// ---------------- writing ----------------
+
+bool serialize_certificate(certificate const& cert, cert_writer& out) {
+	if (auto k4 = dynamic_cast<negative_cert_K4 const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::K4));
+		for (int v : {k4->a, k4->b, k4->c, k4->d}) out.vertex(v);
+		for (auto p : {&k4->ab, &k4->ac, &k4->ad, &k4->bc, &k4->bd, &k4->cd}) {
+			if (!out.path(*p)) return false;
+		}
+	} else if (auto k23 = dynamic_cast<negative_cert_K23 const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::K23));
+		out.vertex(k23->a);
+		out.vertex(k23->b);
+		for (auto p : {&k23->one, &k23->two, &k23->three}) {
+			if (!out.path(*p)) return false;
+		}
+	} else if (auto t4 = dynamic_cast<negative_cert_T4 const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::T4));
+		for (int v : {t4->c1, t4->c2, t4->a, t4->b}) out.vertex(v);
+		for (auto p : {&t4->c1a, &t4->c1b, &t4->c2a, &t4->c2b, &t4->ab}) {
+			if (!out.path(*p)) return false;
+		}
+	} else if (auto cut = dynamic_cast<negative_cert_tri_comp_cut const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::tri_comp_cut));
+		out.vertex(cut->v);
+	} else if (auto comp = dynamic_cast<negative_cert_tri_cut_comp const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::tri_cut_comp));
+		for (int v : {comp->c1, comp->c2, comp->c3}) out.vertex(v);
+	} else if (auto gsp = dynamic_cast<positive_cert_gsp const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::gsp));
+		out.byte(gsp->is_sp ? 1 : 0);
+
+		flat_sp_tree const& flat = gsp->decomposition; // the flat layout is already in post-order, so it's written out as is
+		if (!flat.well_formed) return false;		// don't let a malformed tree be "repaired" by writing it out
+
+		out.varint(flat.nodes.size());
+		for (flat_sp_node const& node : flat.nodes) {
+			out.byte((unsigned char)(node.comp));
+			out.vertex(node.source);
+			out.vertex(node.sink);
+		}
+	} else if (auto op = dynamic_cast<positive_cert_op const *>(&cert)) {
+		out.byte((unsigned char)(cert_tag::op));
+		out.varint(op->boundaries.size());
+		for (std::vector<edge_t> const& boundary : op->boundaries) {
+			out.varint(boundary.size());
+			for (edge_t e : boundary) {
+				out.vertex(e.first);
+				out.vertex(e.second);
+			}
+		}
+	} else {
+		return false; // not a certificate type we know about
+	}
+
+	return true;
+}
+
+bool serialize_result(gsp_sp_op_result const& result, std::vector<unsigned char>& bytes) { // encode a whole result; fails if a reason is missing or malformed
+	cert_writer out;
+	for (char c : {'G', 'S', 'P', 'C'}) out.byte((unsigned char)(c));
+	out.byte(1);
+	out.byte((unsigned char)((result.is_gsp ? 1 : 0) | (result.is_sp ? 2 : 0) | (result.is_op ? 4 : 0)));
+
+	certificate const * reasons[3] = {result.gsp_reason.get(), result.sp_reason.get(), result.op_reason.get()};
+	certificate const * distinct[3];
+	int index[3];
+	int k = 0;
+	for (int i = 0; i < 3; i++) {
+		if (!reasons[i]) return false;
+
+		index[i] = k;
+		for (int j = 0; j < k; j++) {
+			if (distinct[j] == reasons[i]) index[i] = j;
+		}
+		if (index[i] == k) distinct[k++] = reasons[i];
+	}
+
+	out.varint(k);
+	for (int i = 0; i < k; i++) {
+		if (!serialize_certificate(*distinct[i], out)) return false;
+	}
+	for (int i = 0; i < 3; i++) out.varint(index[i]);
+
+	bytes = std::move(out.bytes);
+	return true;
+}
+
+bool write_result_file(std::string const& filename, gsp_sp_op_result const& result) {
+	std::vector<unsigned char> bytes;
+	if (!serialize_result(result, bytes)) return false;
+
+	std::ofstream fout{filename, std::ios::binary};
+	fout.write((char const *)(bytes.data()), (std::streamsize)(bytes.size()));
+	return (bool)(fout);
+}
+
+// ---------------- reading back into certificate objects ----------------
+
+std::shared_ptr<certificate> deserialize_certificate(cert_reader& in, int n) { // n is the order of the graph the certificate is for, every vertex must be less than it
+	cert_tag tag = (cert_tag)(in.byte());
+
+	switch (tag) {
+		case cert_tag::K4: {
+			std::shared_ptr<negative_cert_K4> k4{new negative_cert_K4{}};
+			for (int * v : {&k4->a, &k4->b, &k4->c, &k4->d}) *v = in.vertex(n);
+			for (auto p : {&k4->ab, &k4->ac, &k4->ad, &k4->bc, &k4->bd, &k4->cd}) *p = in.path(n);
+			return k4;
+		}
+		case cert_tag::K23: {
+			std::shared_ptr<negative_cert_K23> k23{new negative_cert_K23{}};
+			k23->a = in.vertex(n);
+			k23->b = in.vertex(n);
+			for (auto p : {&k23->one, &k23->two, &k23->three}) *p = in.path(n);
+			return k23;
+		}
+		case cert_tag::T4: {
+			std::shared_ptr<negative_cert_T4> t4{new negative_cert_T4{}};
+			for (int * v : {&t4->c1, &t4->c2, &t4->a, &t4->b}) *v = in.vertex(n);
+			for (auto p : {&t4->c1a, &t4->c1b, &t4->c2a, &t4->c2b, &t4->ab}) *p = in.path(n);
+			return t4;
+		}
+		case cert_tag::tri_comp_cut: {
+			std::shared_ptr<negative_cert_tri_comp_cut> cut{new negative_cert_tri_comp_cut{}};
+			cut->v = in.vertex(n);
+			return cut;
+		}
+		case cert_tag::tri_cut_comp: {
+			std::shared_ptr<negative_cert_tri_cut_comp> comp{new negative_cert_tri_cut_comp{}};
+			for (int * v : {&comp->c1, &comp->c2, &comp->c3}) *v = in.vertex(n);
+			return comp;
+		}
+		case cert_tag::gsp: { // the records are the flat layout, so they're read straight into it; a stack of the sizes of finished subtrees gives each node its size and rejects records that don't form a single tree
+			std::shared_ptr<positive_cert_gsp> gsp{new positive_cert_gsp{}};
+			gsp->is_sp = (in.byte() != 0);
+			size_t nodes = in.count(in.remaining() / 3);
+			std::vector<flat_sp_node>& flat = gsp->decomposition.nodes;
+			flat.reserve(nodes);
+			std::vector<int> done;
+
+			for (size_t i = 0; i < nodes && in.ok; i++) {
+				unsigned char comp = in.byte();
+				int source = in.vertex(n);
+				int sink = in.vertex(n);
+				if (comp > (unsigned char)(c_type::dangling)) in.ok = false;
+				if (!in.ok) break;
+
+				if ((c_type)(comp) == c_type::edge) {
+					flat.push_back({source, sink, 1, c_type::edge});
+					done.push_back(1);
+					continue;
+				}
+
+				if (done.size() < 2) {
+					in.ok = false;
+					break;
+				}
+				int size = 1 + done.back() + done[done.size() - 2];
+				done.pop_back();
+				done.back() = size;
+				flat.push_back({source, sink, size, (c_type)(comp)}); // the stored source and sink are kept as they are, so a tampered file fails authentication instead of being silently repaired
+			}
+
+			if (!in.ok || done.size() != 1) return nullptr;
+			return gsp;
+		}
+		case cert_tag::op: {
+			std::shared_ptr<positive_cert_op> op{new positive_cert_op{}};
+			size_t bicomps = in.count(in.remaining());
+			op->boundaries.resize(bicomps);
+			for (std::vector<edge_t>& boundary : op->boundaries) {
+				size_t edges = in.count(in.remaining() / 2);
+				boundary.reserve(edges);
+				for (size_t i = 0; i < edges && in.ok; i++) {
+					int first = in.vertex(n);
+					int second = in.vertex(n);
+					boundary.emplace_back(first, second);
+				}
+			}
+			return op;
+		}
+	}
+
+	in.ok = false;
+	return nullptr;
+}
+
+bool read_result_header(cert_reader& in, unsigned char& flags) {
+	for (char c : {'G', 'S', 'P', 'C'}) {
+		if (in.byte() != (unsigned char)(c)) return false;
+	}
+	if (in.byte() != 1) return false; // unknown version
+
+	flags = in.byte();
+	return in.ok;
+}
+
+bool deserialize_result(unsigned char const * data, size_t size, int n, gsp_sp_op_result& result) { // decode a result for a graph of order n, rebuilding all the certificate objects
+	cert_reader in{data, size};
+	unsigned char flags;
+	if (!read_result_header(in, flags)) return false;
+
+	size_t k = in.count(3);
+	std::vector<std::shared_ptr<certificate>> certs;
+	for (size_t i = 0; i < k && in.ok; i++) {
+		certs.push_back(deserialize_certificate(in, n));
+		if (!certs.back()) return false;
+	}
+
+	std::shared_ptr<certificate> * reasons[3] = {&result.gsp_reason, &result.sp_reason, &result.op_reason};
+	for (int i = 0; i < 3; i++) {
+		size_t index = in.count(k);
+		if (!in.ok || index >= k) return false;
+		*reasons[i] = certs[index];
+	}
+
+	result.is_gsp = flags & 1;
+	result.is_sp = flags & 2;
+	result.is_op = flags & 4;
+	return in.ok && in.remaining() == 0;
+}
+
+// ---------------- streaming verification ----------------
+
+bool authenticate_serialized_decomposition(cert_reader& in, graph const& g) { // authenticate a serialized decomposition tree record (after its type byte) as it is read, without building a tree at all
+																			   // the records are in post-order, so the only thing kept is the (source, sink) of every finished subtree whose parent hasn't been read yet (at most one per level of the tree)
+	bool is_sp = (in.byte() != 0);
+	size_t nodes = in.count(in.remaining() / 3);
+	L_LOG("====== STREAMING " << nodes << " SERIALIZED DECOMPOSITION TREE NODES ======\n")
+
+	sp_decomposition_checker check{g, is_sp};
+	std::vector<edge_t> done;
+
+	for (size_t i = 0; i < nodes; i++) {
+		unsigned char comp = in.byte();
+		int source = in.vertex(g.n);
+		int sink = in.vertex(g.n);
+		if (!in.ok || comp > (unsigned char)(c_type::dangling)) {
+			L_LOG("====== AUTH FAILED: decomposition tree record " << i << " is corrupt ======\n\n")
+			return false;
+		}
+
+		if ((c_type)(comp) == c_type::edge) {
+			if (!check.edge(source, sink)) return false;
+		} else {
+			if (done.size() < 2) {
+				L_LOG("====== AUTH FAILED: node " << source << c_type_char((c_type)(comp)) << sink << " malformed (missing children) ======\n\n")
+				return false;
+			}
+
+			edge_t r = done.back();
+			done.pop_back();
+			edge_t l = done.back();
+			done.pop_back();
+			if (!check.compose((c_type)(comp), source, sink, l, r)) return false;
+		}
+
+		done.emplace_back(source, sink);
+	}
+
+	if (done.size() != 1) {
+		L_LOG("====== AUTH FAILED: decomposition tree " << (done.empty() ? "does not exist" : "is not a single tree") << " ======\n\n")
+		return false;
+	}
+
+	return check.finish(done[0].first, done[0].second);
+}
+
+bool verify_serialized_result(unsigned char const * data, size_t size, graph const& g) { // authenticate every certificate in a serialized result against g, and check the flags agree with the kinds of certificate given
+																						  // decomposition trees are streamed; the other certificates are small (O(|V|)) so they are decoded and authenticated as usual
+	cert_reader in{data, size};
+	unsigned char flags;
+	if (!read_result_header(in, flags)) {
+		L_LOG("====== AUTH FAILED: not a certificate file ======\n\n")
+		return false;
+	}
+
+	size_t k = in.count(3);
+	cert_tag tags[3];
+	bool sp_tree_flag[3] = {false, false, false}; // is_sp of each decomposition tree
+	for (size_t i = 0; i < k; i++) {
+		unsigned char const * record = in.pos;
+		tags[i] = (cert_tag)(in.byte());
+
+		if (tags[i] == cert_tag::gsp) {
+			sp_tree_flag[i] = (in.pos < in.end && *in.pos != 0);
+			if (!authenticate_serialized_decomposition(in, g)) return false;
+		} else {
+			in.pos = record;
+			std::shared_ptr<certificate> cert = deserialize_certificate(in, g.n);
+			if (!in.ok || !cert || !cert->authenticate(g)) return false;
+		}
+	}
+
+	int index[3];
+	for (int i = 0; i < 3; i++) {
+		index[i] = (int)(in.count(k));
+		if (!in.ok || (size_t)(index[i]) >= k) return false;
+	}
+
+	if (in.remaining() != 0) {
+		L_LOG("====== AUTH FAILED: trailing bytes after certificates ======\n\n")
+		return false;
+	}
+
+	bool is_gsp = flags & 1, is_sp = flags & 2, is_op = flags & 4;
+	if (is_gsp != (tags[index[0]] == cert_tag::gsp) ||
+		is_sp != (tags[index[1]] == cert_tag::gsp && sp_tree_flag[index[1]]) ||
+		is_op != (tags[index[2]] == cert_tag::op)) {
+		L_LOG("====== AUTH FAILED: result flags do not match the certificates given ======\n\n")
+		return false;
+	}
+
+	L_LOG("this graph is " << (is_gsp ? "" : "NOT ") << "GSP, " << (is_sp ? "" : "NOT ") << "SP, and " << (is_op ? "" : "NOT ") << "OP\n")
+	return true;
+}
+
+bool verify_result_file(std::string const& filename, graph const& g) { // memory-map a certificate file (or read it, where mmap isn't available) and verify it against g
+	#ifdef __GSP_HAVE_MMAP__
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return false;
+	}
+
+	void * map = mmap(nullptr, (size_t)(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid after the descriptor is closed
+	if (map != MAP_FAILED) {
+		madvise(map, (size_t)(st.st_size), MADV_SEQUENTIAL); // we only ever read it front to back
+		bool ok = verify_serialized_result((unsigned char const *)(map), (size_t)(st.st_size), g);
+		munmap(map, (size_t)(st.st_size));
+		return ok;
+	}
+	#endif
+
+	std::ifstream fin{filename, std::ios::binary};
+	std::vector<unsigned char> bytes{std::istreambuf_iterator<char>{fin}, std::istreambuf_iterator<char>{}};
+	return !bytes.empty() && verify_serialized_result(bytes.data(), bytes.size(), g);
+}
+
+#endif
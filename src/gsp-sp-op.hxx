@@ -7,43 +7,59 @@
 #include "sp-tree.hxx"
 #include "logging.hxx"
 #include "gsp-sp-op-certificates.hxx"
+#include "resumable.hxx"
+#include "small-graph.hxx"
+#include "packed-graph.hxx"
 #include <vector>
 #include <stack>
+#include <stdexcept>
 #include <ostream>
 #include <memory>
+#include <optional>
 #include <algorithm>
+#include <type_traits>
 
 // ====================================================== GSP-SP-OP ===========================================================
 
-std::vector<std::pair<int, int>> get_bicomps(graph const&, std::vector<int>&, gsp_sp_op_result&, int = 0);
-void report_K4_non_stack_pop_case(gsp_sp_op_result&, std::vector<int> const&, std::vector<std::stack<sp_chain_stack_entry>>&, int, int, int, int, int, int);
-void K23_test(std::shared_ptr<certificate>&, std::vector<int>&, std::vector<int> const&, edge_t, edge_t, int);
+template <typename Graph, typename meter>
+resumable<std::vector<std::pair<int, int>>> get_bicomps(Graph const&, vertex_array<Graph, int>&, gsp_sp_op_result&, meter&, int = 0);
+template <typename int_array, typename stack_array>
+void report_K4_non_stack_pop_case(gsp_sp_op_result&, int_array const&, stack_array&, int, int, int, int, int, int);
+template <typename int_array>
+void K23_test(std::shared_ptr<certificate>&, int_array&, int_array const&, edge_t, edge_t, int);
 int path_contains_edge(std::vector<edge_t> const&, edge_t);
+template <typename Graph, typename int_array>
+bool T4_at_fake_edge(Graph const&, int_array const&, int, int, int, negative_cert_T4&);
 
-gsp_sp_op_result GSP_SP_OP(graph const& g) {
+template <typename Graph, typename meter>
+resumable<gsp_sp_op_result> gsp_sp_op_steps(Graph const& g, meter& work) { // the whole of GSP-SP-OP as a coroutine, which suspends (between steps of its DFSes) whenever work is exhausted
+																					 // Graph is a graph or anything else with the same interface (see graph.hxx), such as a subgraph_view; graph_storage<Graph> chooses the containers for the per-vertex state
+																					 // meter is a work_meter, or unmetered_work (see resumable.hxx) to run it to completion without counting anything
 	gsp_sp_op_result retval{};
 	std::shared_ptr<positive_cert_op> op{new positive_cert_op{}}; // the edges making up the exterior boundary of an outerplanar embedding of G
 
-	std::vector<int> cut_verts(g.n, -1);										// cut_verts[i] is -1 if vertex i is not a cut vertex, and a unique number from 0 to (the number of biconnected components of G) - 1 otherwise
-	std::vector<edge_t> bicomps = get_bicomps(g, cut_verts, retval);			// get the bicomps of G
+	vertex_array<Graph, int> cut_verts((size_t)(g.n), -1);						// cut_verts[i] is -1 if vertex i is not a cut vertex, and a unique number from 0 to (the number of biconnected components of G) - 1 otherwise
+	resumable<std::vector<edge_t>> bicomp_search = get_bicomps(g, cut_verts, retval, work);
+	while (!bicomp_search.step()) co_await std::suspend_always{}; // the bicomp search shares our budget, so we suspend whenever it does
+	std::vector<edge_t> bicomps = bicomp_search.take();						// get the bicomps of G
 	int n_bicomps = (int)(bicomps.size());
-	std::vector<sp_tree> cut_vertex_attached_tree((size_t)(n_bicomps));			// cut_vertex_attached_tree[i] is the SP decomposition tree attached to cut vertex i, which we use to stitch together the decomposition trees of bicomps
-	std::vector<int> comp(g.n, -1);												// comp[i] is the biconnected component vertex i belongs to (if a vertex belongs to two or more bicomps, then comp[i] is the unique bicomp whose root vertex is not at vertex i)
+	vertex_array<Graph, sp_tree> cut_vertex_attached_tree((size_t)(n_bicomps));	// cut_vertex_attached_tree[i] is the SP decomposition tree attached to cut vertex i, which we use to stitch together the decomposition trees of bicomps
+	vertex_array<Graph, int> comp((size_t)(g.n), -1);							// comp[i] is the biconnected component vertex i belongs to (if a vertex belongs to two or more bicomps, then comp[i] is the unique bicomp whose root vertex is not at vertex i)
 
-	std::vector<std::stack<sp_chain_stack_entry>> vertex_stacks((size_t)(g.n)); // vertex_stacks[i] is the per-vertex stack we store for vertex i
-	std::vector<int> dfs_no((size_t)(g.n + 1), 0);								// dfs_no[i] is the DFS number of vertex i
-	std::vector<int> parent((size_t)(g.n), 0);									// parent[i] is the parent of vertex i
+	vertex_array<Graph, sp_chain_stack> vertex_stacks((size_t)(g.n));			// vertex_stacks[i] is the per-vertex stack we store for vertex i
+	vertex_array<Graph, int> dfs_no((size_t)(g.n + 1), 0);						// dfs_no[i] is the DFS number of vertex i
+	vertex_array<Graph, int> parent((size_t)(g.n), 0);							// parent[i] is the parent of vertex i
 
-	std::vector<edge_t> ear((size_t)(g.n), edge_t{g.n, g.n});					// ear[i] is the back edge associated with the ear containing the edge between vertex i and its parent in the DFS tree
+	vertex_array<Graph, edge_t> ear((size_t)(g.n), edge_t{g.n, g.n});			// ear[i] is the back edge associated with the ear containing the edge between vertex i and its parent in the DFS tree
 																				// the lexicographic infinity is defined as (g.n, g.n), and the DFS number of either of its endpoints is also g.n
 																				// the first entry in the pair is the source of the back edge of the ear and the second is the sink of the back edge of the ear
-	std::vector<sp_tree> seq((size_t)(g.n));									// seq[i] is the last SP subgraph in the i-SP chain (after the DFS backs from vertex i to its parent, it will be finished and ready to use)
-	std::vector<int> earliest_outgoing((size_t)(g.n), g.n);						// earliest_outgoing[i] is the source of the lexicographically earliest outgoing ear whose sink is at vertex i, or s_w in the paper
+	vertex_array<Graph, sp_tree> seq((size_t)(g.n));							// seq[i] is the last SP subgraph in the i-SP chain (after the DFS backs from vertex i to its parent, it will be finished and ready to use)
+	vertex_array<Graph, int> earliest_outgoing((size_t)(g.n), g.n);				// earliest_outgoing[i] is the source of the lexicographically earliest outgoing ear whose sink is at vertex i, or s_w in the paper
 																				// vertex g.n is the ancestral infinity, and all other vertices are proper ancestors of it
 
-	std::vector<char> num_children((size_t)(g.n), 0);							// num_children[i] is the number of children of vertex i in the DFS tree
+	vertex_array<Graph, char> num_children((size_t)(g.n), 0);					// num_children[i] is the number of children of vertex i in the DFS tree
 																				// only needs to be 0, 1, or 2, so it's a 1-byte char to save memory
-	std::vector<int> alert((size_t)(g.n), -1);									// alert[i] -1 if there isn't any, or the source of the back edge of that ear if there is a non-trivial ear whose sink is i and whose source is parent[i] (this back edge is 'b' in the paper)
+	vertex_array<Graph, int> alert((size_t)(g.n), -1);							// alert[i] -1 if there isn't any, or the source of the back edge of that ear if there is a non-trivial ear whose sink is i and whose source is parent[i] (this back edge is 'b' in the paper)
 																				// if there are two of such ears with sink on a vertex, there is a 3.5(b) violation and we report a K23 for non-outerplanar-ness (but may still be SP)
 																				// NOTE: it might be possible to recover b, alert, and the number of children just by examining the vertex stack of v (seeing if the top entry on that stack has an end at w, which is O(1) time)
 																				// this would save a fair bit of memory (you wouldn't need either of the above two arrays), but I haven't proven the correctness of it so I'll just stick with the approach given in the paper
@@ -52,17 +68,22 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 																				// the space usage is still O(|V| + |E|), but maybe if I were to optimize the memory use in the future I'd get rid of most of these and put them in the DFS stack frames 
 																				// this would probably around halve the memory use for sparser graphs where the DFS frequently backtracks, and massively cut it down for early exits due to K4
 
-	std::stack<std::pair<int, int>> dfs;  // I implement the DFS iteratively rather than recursively to avoid stack overflows on exceptionally large input graphs
+	std::stack<std::pair<int, int>, vertex_array<Graph, std::pair<int, int>>> dfs;  // I implement the DFS iteratively rather than recursively to avoid stack overflows on exceptionally large input graphs
 										  // the first entry in each pair of this stack represents the w of one recursive call, and the second entry the current index in the adjacency list we're looking at for that vertex
 										  // my predecessor has done something similar in their "dfs2-using-2d-vector.cpp", but they scan over the entire adjacency list every time to find a not-yet-visited descendant instead of keeping track of the adj address (which is O(|E^2|) time instead of O(|E|) like my approach is)
 
 	dfs_no[g.n] = g.n; // dfs_no[g.n] is g.n, a special value of the DFS number for the lexicographic and ancestral infinity
 
+	vertex_array<Graph, int> journal;  // the vertices whose per-vertex state was written while processing the current bicomp, recorded only while its first edge may be fake
+							   // if a K4 through the fake edge forces us to reprocess a bicomp that is a small part of a huge graph, rolling back only these entries avoids a scan over the whole graph
+
 	bool do_k23_edge_replacement = true; // flag to avoid uselessly redoing the work of checking if we've already successfully replaced a fake edge on a K23 to ensure we only make that check once
+	int plain_rerun = -1; // a bicomp being reprocessed from its real first edge because a K4 through its fake edge left no T4 on its cut vertices (see below)
 
 	for (int bicomp = 0; bicomp < n_bicomps; bicomp++) {
 		N_LOG("BICOMP " << bicomp << "\n")
 
+		bool had_op_reason = (bool)(retval.op_reason); // whether a K23 was found in an earlier bicomp (as opposed to one found while processing this one)
 		if (!retval.op_reason) {
 			op->boundaries.emplace_back(); // add a new bicomp to the exterior boundary if we haven't found K23 yet
 		}
@@ -70,7 +91,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 
 		int root = bicomps[bicomp].first;
 		int next;
-		if (!retval.sp_reason && bicomp > 0 && bicomp < n_bicomps - 1) { // case where 1 < i < h and sp != false in the paper, we generate a potentially fake edge between the two cut vertices attached to this bicomp
+		if (!retval.sp_reason && bicomp != plain_rerun && bicomp > 0 && bicomp < n_bicomps - 1) { // case where 1 < i < h and sp != false in the paper, we generate a potentially fake edge between the two cut vertices attached to this bicomp
 			next = bicomps[bicomp - 1].first; // go to the cut vertex of the previous bicomp
 		} else {
 			next = bicomps[bicomp].second; // proceed as normal
@@ -80,9 +101,9 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 		dfs.emplace(next, 0); // force the first edge of the DFS
 
 		bool fake_edge = false; // keep track of whether the edge we added was fake or not; we'll check this at the end of the processing of this bicomp
-		if (!retval.sp_reason) { // we only need to care about fake edges if the bicomps form a chain (otherwise there will never be a fake edge)
+		if (!retval.sp_reason && bicomp != plain_rerun) { // we only need to care about fake edges if the bicomps form a chain (otherwise there will never be a fake edge)
 			fake_edge = true;
-			for (int u1 : g.adjLists[next]) { // iterate over the adj list of the tree child of the root to check if the first edge in the DFS tree doesn't exist (as it might when the bicomps form a chain)
+			for (int u1 : g.neighbors(next)) { // iterate over the adj list of the tree child of the root to check if the first edge in the DFS tree doesn't exist (as it might when the bicomps form a chain)
 										  // over the whole algorithm this takes O(|E|) time, we are guaranteed to run this loop at most once per vertex (since we always run it on a non-root-vertex of a bicomp, and when bicomps overlap exactly one of those bicomps do not have a root vertex on the overlap)
 				if (u1 == root) {
 					fake_edge = false;
@@ -96,17 +117,20 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 		dfs_no[next] = 2;
 		parent[next] = root;
 		comp[next] = bicomp;
+		journal.clear();
+		if (fake_edge) journal.push_back(next);
 		int curr_dfs = 3;
 
 		// ==================== SP-OP begins here ====================
 
 		while (!dfs.empty()) { // the DFS is implemented iteratively rather than recursively to avoid stack overflows on exceptionally large input graphs, but is equivalent to what's in the paper
+			if (work.exhausted()) co_await std::suspend_always{}; // suspend here if we've used up our budget (this is the only place the classifier suspends in SP-OP, so every other bit of state is consistent whenever it's suspended)
 			std::pair<int, int> p = dfs.top();
 			int v = parent[p.first]; // v is the parent of w in the DFS tree, u is the current vertex being examined in w's adjacency list (which I will call the "child" but this is not quite accurate since the edge between u and w could be a back edge)
 			int w = p.first;
-			int u = g.adjLists[p.first][p.second];
+			int u = g.neighbor(p.first, p.second); // -1 if this entry is outside a subgraph_view
 
-			if (comp[u] == -1 || comp[u] == bicomp) { // skip over child if it isn't part of this bicomp
+			if (u != -1 && (comp[u] == -1 || comp[u] == bicomp)) { // skip over child if it isn't part of this bicomp (or the graph)
 				V_LOG("v: " << v << " w: " << w << " u: " << u << "\n")
 				V_LOG("seq_w: " << seq[w] << ", seq_u: " << seq[u] << "\n")
 				if (dfs_no[u] == 0) { // the first time we see this child node, if it's unvisited and it's in this bicomp, make a recursive call
@@ -114,6 +138,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 					parent[u] = w;
 					dfs_no[u] = curr_dfs++;
 					comp[u] = bicomp;
+					if (fake_edge) journal.push_back(u); // every other array we write per vertex in this bicomp is indexed by a vertex that got its comp here
 					num_children[w]++; // will never exceed 3 if the graph is outerplanar (we are guaranteed to find a K23 violation if it becomes 3)
 									   // if it's not outerplanar, the char might suffer from integer overflow, but this is ok since we don't care about the contents this array once G is not outerplanar
 
@@ -254,7 +279,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 				}
 			}
 
-			if ((size_t)(++dfs.top().second) >= g.adjLists[p.first].size()) { // if we're done processing this vertex's adj list, we're ready to return to the parent
+			if (++dfs.top().second >= g.degree(p.first)) { // if we're done processing this vertex's adj list, we're ready to return to the parent
 				if (w != root) {
 					if (earliest_outgoing[w] != g.n) { // if there's an ear whose sink is at w, we've created a new link in the SP chain for all proper ancestors of this vertex until we reach the source of that ear
 													   // we need to move our current sequence to the tail of that new link to reflect this
@@ -305,6 +330,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 
 		// ==================== SP-OP ends here ====================
 
+		while (!dfs.empty()) dfs.pop(); // the DFS stops before backing into the root (or at a K4), so the root's entry and a few others are still on the stack; left there, they'd pile up over every bicomp and overflow the fixed-size stack of a small_graph
 		dfs_no[root] = 0; // clear the dfs_no of the root so the DFS for future bicomps can revisit it
 
 		if (!retval.op_reason) {
@@ -332,45 +358,57 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 				int pnum = 0;
 				for (; pnum < 6; pnum++) {
 					if (path_contains_edge(*(k4_paths[pnum]), fake) != -1) break; // if this path contains the fake edge, eliminate it and put the other paths in a T4
-																				  // note that by a similar argument to the one about replacing edges in K23's in the paper, either a) the fake edge is between two terminating vertices of the K4 or b) there is a K4 in the bicomp without the fake edge
+																				  // note that by a similar argument to the one about replacing edges in K23's in the paper, either a) the fake edge is between two terminating vertices of the K4, b) there is a K4 in the bicomp without the fake edge, or c) the bicomp has a T4 on the cut vertices we can find without the K4 (see T4_at_fake_edge)
 				}
 
 				if (pnum != 6) {
 					N_LOG("FAKE EDGE IN K4 (pnum " << pnum << "), GENERATE T4\n")
 					std::shared_ptr<negative_cert_T4> t4{new negative_cert_T4{}}; // generate t4
 
-					t4->c1a = std::move(*(k4_paths[k4_t4_translation[pnum][0]]));
-					t4->c2a = std::move(*(k4_paths[k4_t4_translation[pnum][1]]));
-					t4->c1b = std::move(*(k4_paths[k4_t4_translation[pnum][2]]));
-					t4->c2b = std::move(*(k4_paths[k4_t4_translation[pnum][3]]));
-					t4->ab = std::move(*(k4_paths[k4_t4_translation[pnum][4]]));
-					t4->c1 = k4_verts[k4_t4_endpoint_translation[pnum][0]];
-					t4->c2 = k4_verts[k4_t4_endpoint_translation[pnum][1]];
-					t4->a = k4_verts[k4_t4_endpoint_translation[pnum][2]];
-					t4->b = k4_verts[k4_t4_endpoint_translation[pnum][3]];
-
-					retval.sp_reason = t4;
+					if (k4_paths[pnum]->size() == 1) { // the fake edge is a whole path of the K4, so the cut vertices are two of its terminating vertices and the other five paths are a T4 on them
+						t4->c1a = std::move(*(k4_paths[k4_t4_translation[pnum][0]]));
+						t4->c2a = std::move(*(k4_paths[k4_t4_translation[pnum][1]]));
+						t4->c1b = std::move(*(k4_paths[k4_t4_translation[pnum][2]]));
+						t4->c2b = std::move(*(k4_paths[k4_t4_translation[pnum][3]]));
+						t4->ab = std::move(*(k4_paths[k4_t4_translation[pnum][4]]));
+						t4->c1 = k4_verts[k4_t4_endpoint_translation[pnum][0]];
+						t4->c2 = k4_verts[k4_t4_endpoint_translation[pnum][1]];
+						t4->a = k4_verts[k4_t4_endpoint_translation[pnum][2]];
+						t4->b = k4_verts[k4_t4_endpoint_translation[pnum][3]];
+					} else if (T4_at_fake_edge(g, comp, bicomp, root, next, *t4)) { // the fake edge is in the middle of a path of the K4, so the K4's terminating vertices aren't the cut vertices and we have to find the T4 separately
+						N_LOG("FAKE EDGE INSIDE A PATH OF THE K4, SEARCHED FOR T4\n")
+					} else { // and if there's no T4 on the cut vertices, the bicomp has a K4 without the fake edge (case b above); the five other paths aren't a certificate of anything, so reprocess the bicomp from its real first edge to find that K4 instead
+						N_LOG("FAKE EDGE INSIDE A PATH OF THE K4 AND NO T4, REPROCESS WITHOUT IT\n")
+						t4.reset();
+						plain_rerun = bicomp;
+					}
+
+					if (t4) retval.sp_reason = t4;
 					retval.gsp_reason.reset(); // remove k4
 
-					for (int i = 0; i < g.n; i++) { // reset bicomp data (this requires checking over the whole graph because of how I represented the bicomps, but fortunately it is guaranteed to happen at most once so this step is O(|V|) time)
-						if (comp[i] == bicomp) {
-							dfs_no[i] = 0;
-							parent[i] = 0;
-							ear[i] = edge_t{g.n, g.n};
-							num_children[i] = 0;
-							alert[i] = -1;
-							earliest_outgoing[i] = g.n;
-							seq[i] = sp_tree{};
-							vertex_stacks[i] = std::stack<sp_chain_stack_entry>{};
-						}
+					for (int i : journal) { // roll back the bicomp data using the journal, so a small bicomp in a huge graph costs only the vertices the aborted pass reached
+						dfs_no[i] = 0;
+						parent[i] = 0;
+						ear[i] = edge_t{g.n, g.n};
+						num_children[i] = 0;
+						alert[i] = -1;
+						earliest_outgoing[i] = g.n;
+						seq[i] = sp_tree{};
+						vertex_stacks[i] = sp_chain_stack{};
+					}
+					journal.clear(); // the reprocessing itself still needs a second traversal: without the fake edge the DFS is rooted on a different first edge, so the DFS numbers, parents and ears of the aborted pass (and everything built from them) don't carry over
+					if (!had_op_reason) {
+						op->boundaries.pop_back(); // reset ext boundary
+						retval.op_reason.reset(); // a K23 found in this pass may use the fake edge, and the state we'd need to splice it out of the K23 is gone now; the reprocessing has no fake edge and will find a K23 again if there is one
 					}
-					op->boundaries.pop_back(); // reset ext boundary
 
 					bicomp--; // reprocess this bicomp
+					continue;
 				}
 			} // end of fake edge K4 handling
 
-			if (retval.op_reason && do_k23_edge_replacement) { // if there is a fake edge and a reported K23 contains it, we need to correct the K23 by replacing that edge with an ear corresponding to a tree child of this vertex not in the K23
+			if (retval.op_reason && do_k23_edge_replacement && !retval.gsp_reason) { // if there is a fake edge and a reported K23 contains it, we need to correct the K23 by replacing that edge with an ear corresponding to a tree child of this vertex not in the K23
+																					 // not if there's a K4 that doesn't contain the fake edge, though; it replaces the K23 anyway, and it stopped the DFS partway, so the tree children of next may not have ears yet
 				std::shared_ptr<negative_cert_K23> k23 = std::dynamic_pointer_cast<negative_cert_K23>(retval.op_reason);
 				std::vector<edge_t> * k23_paths[3] = {&k23->one, &k23->two, &k23->three}; 
 
@@ -386,8 +424,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 					N_LOG("FAKE EDGE IN K23 (" << violating_path[path_ind].first << ", " << violating_path[path_ind].second << "), REPLACE WITH PATH\n")
 
 					std::vector<edge_t> splice_path;
-					bool in_k23[g.n];
-					for (int i = 0; i < g.n; i++) in_k23[i] = false;
+					vertex_array<Graph, char> in_k23((size_t)(g.n), false); // not a variable-length array, since those can't live in a coroutine frame
 
 					for (std::vector<edge_t> * path : k23_paths) { // mark every vertex in the K23
 						for (edge_t e : *path) {
@@ -397,7 +434,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 						}
 					}
 
-					for (int u2 : g.adjLists[next]) { // find tree child not in K23
+					for (int u2 : g.neighbors(next)) { // find tree child not in K23
 						if (comp[u2] == bicomp && parent[u2] == next && !in_k23[u2]) { // found it, generate tree path
 							V_LOG("FOUND TREE CHILD OF NEXT " << next << " NOT IN K23: " << u2 << ", ear (" << ear[u2].first << ", " << ear[u2].second << ")\n")
 							splice_path.emplace_back(ear[u2].first, root);
@@ -416,6 +453,7 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 
 		if (retval.op_reason) do_k23_edge_replacement = false; // if we found a K23 this bicomp, there's no need to check for K23 fake edge replacement anymore (either it didn't have a fake edge or it did have a fake edge and that edge got replaced above)
 
+		if (bicomp == plain_rerun && !retval.gsp_reason) throw std::logic_error{"GSP_SP_OP: a bicomp with a K4 through its fake edge and no T4 on its cut vertices has no other K4"}; // the argument above says this can't happen; if it ever does, there's no certificate left to give, so don't return a result that fails authentication
 		if (retval.gsp_reason) { // if K4, we are done
 			retval.sp_reason = retval.gsp_reason;
 			retval.op_reason = retval.gsp_reason;
@@ -439,7 +477,8 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 			if (!retval.gsp_reason) { // if there are no K4s preventing GSP, output the completed certificate
 				std::shared_ptr<positive_cert_gsp> gsp{new positive_cert_gsp{}}; // move the finished decomp tree into place if we have not found k4
 
-				gsp->decomposition = std::move(seq[next]);
+				gsp->decomposition = flat_sp_tree{seq[next]}; // freeze the tree into the certificate; this is the only traversal of the pointer tree, which isn't kept
+				seq[next] = sp_tree{};
 				//gsp->decomposition.deantiparallelize(); // optional step for deantiparallelization (it's still O(|V| + |E|) time to do this, but the paper doesn't suggest it)
 														  // UPDATE: deantiparallelization no longer works on non-biconnected graphs for reasons explained in gsp-sp-op-certificates.hxx (in short, the dangling composition is attached to the wrong edge if there's a swap)
 				retval.gsp_reason = gsp;
@@ -470,19 +509,88 @@ gsp_sp_op_result GSP_SP_OP(graph const& g) {
 		}
 	#endif
 
-	return retval;
+	co_return retval;
+}
+
+template <typename Graph>
+gsp_sp_op_result gsp_sp_op_direct(Graph const& g) { // classify G in one go as the type it is, which is just running gsp_sp_op_steps once without a meter, so it never suspends or checks whether it should
+	unmetered_work unlimited;
+	resumable<gsp_sp_op_result> steps = gsp_sp_op_steps(g, unlimited);
+	steps.step();
+	return steps.take();
+}
+
+template <typename Graph>
+gsp_sp_op_result GSP_SP_OP(Graph const& g) { // classify G in one go
+											 // a graph with at most 128 vertices is copied into a small_graph first (see small-graph.hxx), which gives exactly the same result without allocating any per-vertex state
+											 // with -D__PAGE_ALLOCATOR__, any larger graph is copied into a packed_graph (see packed-graph.hxx), so its adjacency lists are on the same kind of pages as the rest of the implementation's state
+	if constexpr (std::is_same_v<Graph, graph>) {
+		if (g.n <= 64 && small_graph<64>::fits(g)) return gsp_sp_op_direct(small_graph<64>{g});
+		if (g.n <= 128 && small_graph<128>::fits(g)) return gsp_sp_op_direct(small_graph<128>{g});
+#ifdef __PAGE_ALLOCATOR__
+		return gsp_sp_op_direct(packed_graph{g});
+#endif
+	}
+
+	return gsp_sp_op_direct(g);
 }
 
-std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp_sp_op_result& cert_out, int root) {	 // determine the biconnected components of G (rather, their root vertices (the first element of the pairs) and an outgoing edge from those root vertices (whose other vertex is the second element of those pairs))
+template <typename Graph = graph>
+struct gsp_sp_op_classifier { // classifies a graph a bounded chunk of work at a time, so e.g. an event loop can interleave a huge graph with other requests instead of blocking on it
+							  // the graph must outlive the classifier
+	Graph const& g;
+	std::unique_ptr<work_meter> meter; // kept on the heap since the coroutine holds a reference to it, so the classifier can be moved
+	resumable<gsp_sp_op_result> steps;
+	long long expected_work;		   // roughly how many units of work the whole classification takes (one per adjacency list entry for each of the two DFSes, plus one per vertex for each), for progress reporting
+	bool finished = false;
+	bool was_cancelled = false;
+	bool taken = false;
+
+	explicit gsp_sp_op_classifier(Graph const& g_) : g{g_}, meter{new work_meter{}}, expected_work{2 * (2 * (long long)(g_.e) + g_.n) + 1} {
+		steps = gsp_sp_op_steps(g, *meter);
+	}
+
+	bool resume(long long budget) { // do at most about budget more units of work, and return whether the classifier is done (finished or cancelled)
+									// a graph needing no more than budget units of work is classified completely in the first call
+		if (finished || was_cancelled) return true;
+		meter->limit = meter->done + std::max(budget, 1LL);
+		finished = steps.step();
+		return finished;
+	}
+
+	void cancel() { // stop mid-run and free everything the classification had allocated so far
+		if (finished) return;
+		steps.reset();
+		was_cancelled = true;
+	}
+
+	bool done() const {return finished || was_cancelled;}
+	bool cancelled() const {return was_cancelled;}
+	long long work_done() const {return meter->done;}
+
+	double progress() const { // fraction of the work done so far, from 0 to 1; this is an estimate (reprocessing a bicomp after a T4, or stopping early at a negative certificate, throws it off), so it's capped below 1 until the classifier actually finishes
+		if (finished) return 1;
+		return std::min(0.99, (double)(meter->done) / (double)(expected_work));
+	}
+
+	std::optional<gsp_sp_op_result> result() { // the result, once resume has returned true without the classifier being cancelled; it can only be taken once, and is empty before then, after a cancel, or the second time
+		if (!finished || taken) return std::nullopt;
+		taken = true;
+		return steps.take();
+	}
+};
+
+template <typename Graph, typename meter>
+resumable<std::vector<edge_t>> get_bicomps(Graph const& g, vertex_array<Graph, int>& cut_verts, gsp_sp_op_result& cert_out, meter& work, int root) {	 // determine the biconnected components of G (rather, their root vertices (the first element of the pairs) and an outgoing edge from those root vertices (whose other vertex is the second element of those pairs))
 																														 // the paper suggests using "Tarjan's algorithm" to accomplish this
 																														 // I do not know what that is (and cannot figure out how to access the reference in the paper), so instead I have implemented the algorithm in the COMP-4540 textbook to do the same thing, which seems to have the required property that the bicomps are produced in the order of a rooted tree													   							   				 	 			 // this bit of the algorithm also generates negative certificates for a bicomp containing three or more cut vertices or a cut vertex contained in three or more bicomps																													 // the paper does not elaborate on how to generate the tri-cut-comp and tri-comp-cut certificates, so I've filled in the details there a bit; I haven't written up a correctness or time complexity proof for my algorithm but if you want I can
-	std::vector<int> dfs_no((size_t)(g.n), 0); // dfs_no[i] is the DFS number of vertex i
-	std::vector<int> parent((size_t)(g.n), 0); // parent[i] is the parent of vertex i in its adjacency list
-	std::vector<int> low((size_t)(g.n), 0);    // low[i] is the DFS number of the sink of the back edge whose sink has a lowest DFS number among all back edges outgoing from a descendant of vertex i, or just dfs_no[i] if no such back edge exists
+	vertex_array<Graph, int> dfs_no((size_t)(g.n), 0); // dfs_no[i] is the DFS number of vertex i
+	vertex_array<Graph, int> parent((size_t)(g.n), 0); // parent[i] is the parent of vertex i in its adjacency list
+	vertex_array<Graph, int> low((size_t)(g.n), 0);    // low[i] is the DFS number of the sink of the back edge whose sink has a lowest DFS number among all back edges outgoing from a descendant of vertex i, or just dfs_no[i] if no such back edge exists
 
 	std::vector<edge_t> retval; // this list stores the outgoing edges from the root vertices of the bicomps
 								// there's no need to construct whole subgraphs for every bicomp when we'll just end up DFSing from the root vertices of the bicomps anyway in GSP_SP_OP
-	std::stack<std::pair<int, int>> dfs;
+	std::stack<std::pair<int, int>, vertex_array<Graph, std::pair<int, int>>> dfs;
 
 	dfs.emplace(root, 0);
 	dfs_no[root] = 1;
@@ -492,9 +600,15 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 	bool root_cut = false; // root_cut is true if we have seen two or more root vertices of bicomps at the root of the DFS; for all other vertices, we can have at most two bicomps rooted at a vertex before we need to generate a tri-comp-cut negative certificate, but for the root of the DFS we can have at most three (since the root bicomp has no parent)
 
 	while (!dfs.empty()) {
+		if (work.exhausted()) co_await std::suspend_always{}; // suspend here if we've used up our budget; all of the state of the search lives in this coroutine's frame, so it picks up exactly where it left off
 		std::pair<int, int> p = dfs.top();
 		int w = p.first;
-		int u = g.adjLists[p.first][p.second];
+		int u = g.neighbor(p.first, p.second);
+		if (u == -1) { // skip entries outside a subgraph_view
+			if (++dfs.top().second >= g.degree(p.first)) dfs.pop();
+			continue;
+		}
+
 		if (dfs_no[u] == 0) { // recurse if we haven't seen u
 			dfs.push(std::pair{u, 0});
 			parent[u] = w;
@@ -531,7 +645,7 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 			if (dfs_no[u] < low[w]) low[w] = dfs_no[u]; // update low, if the outgoing back edge has a lower DFS number at its sink then it follows that w has at most that value as its low, since w is trivially a descendant of w
 		}
 
-		if ((size_t)(++dfs.top().second) >= g.adjLists[p.first].size()) { // we are done processing the adjacency list of w and are backing up to the parent
+		if (++dfs.top().second >= g.degree(p.first)) { // we are done processing the adjacency list of w and are backing up to the parent
 			dfs.pop(); // end the recursive call
 		}
 	}
@@ -545,7 +659,7 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 	if (!root_cut) cut_verts[root] = -1; // if the root is not a cut vertex, don't mark it as one (the bicomp detection algorithm marks the root of every bicomp found as a cut-vertex, even the root bicomp)
 
 	retval.shrink_to_fit();
-	if (cert_out.sp_reason) return retval; // if we found tri-comp-cut, return early (no need to check for tri-cut-comp or reorder the bicomps)
+	if (cert_out.sp_reason) co_return retval; // if we found tri-comp-cut, return early (no need to check for tri-cut-comp or reorder the bicomps)
 
 	N_LOG("no tri-comp-cut found\n")
 
@@ -555,7 +669,7 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 
 	N_LOG("scanning for bicomp with three cut vertices:\n")
 
-	std::vector<int> prev_cut((size_t)(n_bicomps), -1); // prev_cut[i] is the previous cut vertex we saw when we hit the cut vertex with cut_verts value i, or -1 if there is none
+	vertex_array<Graph, int> prev_cut((size_t)(n_bicomps), -1); // prev_cut[i] is the previous cut vertex we saw when we hit the cut vertex with cut_verts value i, or -1 if there is none
 	int root_one = -1; 									// two additional child bicomps for the root; the root bicomp is the only bicomp which can have two children in the bicomp tree if there's no tri-comp-cut, so we need some extra variables to keep track of these similar to root_cut
 	int root_two = -1;
 
@@ -581,7 +695,7 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 					N_LOG("NON-SP, bicomp (not at root) with three cut vertices: " << cut->c1 << ", " << cut->c2 << ", " << cut->c3 << "\n")
 
 					cert_out.sp_reason = cut;
-					return retval;
+					co_return retval;
 				}
 				break;
 			}
@@ -601,7 +715,7 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 				N_LOG("NON-SP, bicomp (at root) with three cut vertices: " << cut->c1 << ", " << cut->c2 << ", " << cut->c3 << "\n")
 
 				cert_out.sp_reason = cut;
-				return retval;
+				co_return retval;
 			}
 		}
 	} // end of finding tri-cut-comp, at this point the bicomps are guaranteed to form a chain
@@ -646,13 +760,14 @@ std::vector<edge_t> get_bicomps(graph const& g, std::vector<int>& cut_verts, gsp
 		#endif
 	}
 
-	return retval;
+	co_return retval;
 }
 
 
+template <typename int_array, typename stack_array>
 void report_K4_non_stack_pop_case(gsp_sp_op_result& cert_out,
-								  std::vector<int> const& parent, 
-								  std::vector<std::stack<sp_chain_stack_entry>>& vertex_stacks, 
+								  int_array const& parent, 
+								  stack_array& vertex_stacks, 
 								  int a, 
 								  int b,
 								  int d,
@@ -700,7 +815,8 @@ void report_K4_non_stack_pop_case(gsp_sp_op_result& cert_out,
 	cert_out.gsp_reason = k4;
 }
 
-void K23_test(std::shared_ptr<certificate>& cert_ptr, std::vector<int>& alert, std::vector<int> const& parent, edge_t ear_found, edge_t ear_winning, int w) { // tests for K23, and puts the produced subdivision in cert_ptr if there is a K23
+template <typename int_array>
+void K23_test(std::shared_ptr<certificate>& cert_ptr, int_array& alert, int_array const& parent, edge_t ear_found, edge_t ear_winning, int w) { // tests for K23, and puts the produced subdivision in cert_ptr if there is a K23
 																																	// ear_found is the back-edge corresponding to the non-trivial ear we are testing for violation (note in the paper they just pass in an edge and index the ear array at that edge in this procedure, but I pass in the back-edge of that ear directly and index the array when calling)
 																																	// ear_winning is the ear that cut off that ear (or, in case (c), chosen arbitrarily to be the other ear)
 																																	// w is the sink of that ear
@@ -753,6 +869,115 @@ void K23_test(std::shared_ptr<certificate>& cert_ptr, std::vector<int>& alert, s
 	}
 }
 
+template <typename Graph, typename int_array>
+bool T4_at_fake_edge(Graph const& g, int_array const& comp, int bicomp, int root, int next, negative_cert_T4& t4) { // find a T4 whose cut vertices are the endpoints of the fake edge, for when the K4 reported through the fake edge doesn't have them as terminating vertices (so the other five paths of the K4 aren't a T4)
+																													   // without the fake edge the bicomp is SP (or it has a K4 we'll find when reprocessing it), so every bridge of a cycle through root and next attaches to it at exactly two vertices, and one of them must join the two root-next arcs of the cycle, or adding the fake edge couldn't have made a K4
+																													   // we take any such cycle (two disjoint paths from next to root, with one round of augmenting paths) and search for such a bridge; this is O(|V| + |E|) of the bicomp, and happens at most once since there are no more fake edges after a T4
+	auto inside = [&](int v) {return v != root && (comp[v] == -1 || comp[v] == bicomp);}; // the vertices of the bicomp other than the root, exactly the ones the DFS of the bicomp may visit; we never look at the root's adjacency list, most of which is outside the bicomp
+
+	vertex_array<Graph, int> prev_on((size_t)(g.n), -1); // a plain BFS from next finds the first path from next to root; prev_on[v] and next_on[v] are the vertices before and after v on it
+	vertex_array<Graph, int> next_on((size_t)(g.n), -1);
+	std::vector<int> queue{next};
+	prev_on[next] = next;
+	for (size_t i = 0; i < queue.size() && prev_on[root] == -1; i++) {
+		int v = queue[i];
+		for (int u : g.neighbors(v)) {
+			if (u == -1 || prev_on[u] != -1 || (u != root && !inside(u))) continue;
+			prev_on[u] = v;
+			queue.push_back(u);
+		}
+	}
+	if (prev_on[root] == -1) return false;
+	for (int v = root; v != next; v = prev_on[v]) next_on[prev_on[v]] = v;
+
+	vertex_array<Graph, int> pred_copies[2] = {vertex_array<Graph, int>((size_t)(g.n), -1), vertex_array<Graph, int>((size_t)(g.n), -1)}; // the search predecessors of the in and out copies of every vertex, where copy x is (x / 2)'s in copy if x is even and its out copy if x is odd
+	auto pred = [&](int x) -> int& {return pred_copies[x % 2][x / 2];};
+	queue.assign(1, 2 * next + 1); // then search the residual graph for an augmenting path from next's out copy to root's in copy, where the edges of the first path go backwards and its vertices can only be left backwards from their in copy
+	pred(2 * next + 1) = 2 * next + 1;
+	for (size_t i = 0; i < queue.size() && pred(2 * root) == -1; i++) {
+		int x = queue[i], v = x / 2;
+		auto visit = [&](int y) {
+			if (pred(y) == -1) {
+				pred(y) = x;
+				queue.push_back(y);
+			}
+		};
+		bool on_path = v != next && next_on[v] != -1;
+		if (x % 2 == 1) {
+			for (int u : g.neighbors(v)) {
+				if (u != -1 && u != next && u != next_on[v] && (u == root || inside(u))) visit(2 * u);
+			}
+			if (on_path) visit(2 * v);
+		} else if (on_path) {
+			visit(2 * prev_on[v] + 1);
+		} else {
+			visit(2 * v + 1);
+		}
+	}
+	if (pred(2 * root) == -1) return false;
+
+	vertex_array<Graph, int> next_off((size_t)(g.n), -1); // the augmenting path takes edges it goes forwards along, and cancels the ones of the first path it goes backwards along
+	int second = -1; // the first vertex after next on the second path
+	for (int y = 2 * root; y != 2 * next + 1; y = pred(y)) {
+		int x = pred(y);
+		if (x / 2 == y / 2) continue;
+		if (x % 2 == 1) {
+			next_off[x / 2] = y / 2;
+			if (x / 2 == next) second = y / 2;
+		} else {
+			next_on[y / 2] = -2; // y / 2 -> x / 2 was on the first path
+		}
+	}
+
+	std::vector<int> arcs[2]; // the two arcs of the cycle from next to root
+	vertex_array<Graph, int> side((size_t)(g.n), 0); // 1 or 2 on the inside of the arcs, 3 on next (and the root, which we never reach)
+	side[next] = 3;
+	for (int k = 0; k < 2; k++) {
+		arcs[k].push_back(next);
+		for (int v = k == 0 ? next_on[next] : second; v != root; v = next_off[v] != -1 ? next_off[v] : next_on[v]) {
+			if (v < 0) return false; // can't happen, but don't walk off of the paths if it somehow does
+			arcs[k].push_back(v);
+			side[v] = k + 1;
+		}
+		arcs[k].push_back(root);
+	}
+
+	std::fill(prev_on.begin(), prev_on.end(), -1); // lastly, a BFS from the inside of the first arc that stops at the inside of the second one, through vertices off the cycle (prev_on is free again, so it holds the BFS predecessors)
+	queue.assign(arcs[0].begin() + 1, arcs[0].end() - 1);
+	for (int v : queue) prev_on[v] = v;
+	int a = -1, b = -1;
+	for (size_t i = 0; i < queue.size() && b == -1; i++) {
+		int v = queue[i];
+		for (int u : g.neighbors(v)) {
+			if (u == -1 || !inside(u) || (side[u] != 0 && side[u] != 2) || prev_on[u] != -1) continue;
+			prev_on[u] = v;
+			if (side[u] == 2) {
+				b = u;
+				break;
+			}
+			queue.push_back(u);
+		}
+	}
+	if (b == -1) return false;
+
+	for (int v = b; prev_on[v] != v; v = prev_on[v]) t4.ab.emplace_back(v, prev_on[v]);
+	a = t4.ab.back().second;
+	t4.c1 = root;
+	t4.c2 = next;
+	t4.a = a;
+	t4.b = b;
+	std::vector<edge_t> * halves[2][2] = {{&t4.c2a, &t4.c1a}, {&t4.c2b, &t4.c1b}};
+	for (int k = 0; k < 2; k++) {
+		int split = k == 0 ? a : b;
+		int half = 0;
+		for (size_t i = 0; i + 1 < arcs[k].size(); i++) {
+			if (arcs[k][i] == split) half = 1;
+			halves[k][half]->emplace_back(arcs[k][i], arcs[k][i + 1]);
+		}
+	}
+	return true;
+}
+
 int path_contains_edge(std::vector<edge_t> const& path, edge_t test) { // utility for finding if a path contains an edge, used for replacing K4's with T4's and fake edges in K23's
 	for (size_t i = 0; i < path.size(); i++) {
 		edge_t e = path[i];
@@ -0,0 +1,158 @@
+// this file contains invariance trials: classifying one graph under many vertex numberings, DFS roots and adjacency list orders, in parallel, and checking every trial gives the same answer
+// the trials never copy the graph; each worker thread runs the implementation on permuted_views (see graph.hxx) of the shared, read-only host, and only needs two host-sized arrays for the numbering
+// instead of authenticating every trial's certificates, each result is reduced to a result_summary, which doesn't depend on the numbering or the order, and compared with the summary of a reference result (which should itself be authenticated once)
+
+#ifndef __INVARIANCE_TRIALS_HXX__
+#define __INVARIANCE_TRIALS_HXX__
+
+#include "graph.hxx"
+#include "gsp-sp-op.hxx"
+#include "gsp-sp-op-serialization.hxx"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct result_summary { // the parts of a gsp_sp_op_result every run on the same graph must agree on, with vertices in host numbers
+	unsigned char flags = 0;	// bit 0 is is_gsp, bit 1 is_sp, bit 2 is_op, as in certificate files
+	cert_tag reasons[3] = {};	// the kinds of certificate given for gsp_reason, sp_reason and op_reason; the implementation looks for tri-comp-cuts, then tri-cut-comps, then T4s, each of which exists or doesn't regardless of numbering, so even the negative kinds are canonical
+	int tree_edges = 0;			// for a decomposition tree, its number of edges and a hash of them (every tree of a graph has the same edges, however it's composed)
+	uint64_t tree_hash = 0;
+	int bicomps = 0;			// for an exterior boundary, its number of bicomps and a hash of each bicomp's boundary edges (a biconnected outerplanar graph has exactly one Hamiltonian cycle, so the boundaries are canonical too)
+	uint64_t boundary_hash = 0;
+
+	bool operator==(result_summary const&) const = default;
+};
+
+uint64_t summary_edge_hash(int u, int v, int const * global) { // a hash of an edge in host numbers, the same in either direction; global is the view's numbering, or null for the host's own
+	if (global) {
+		u = global[u];
+		v = global[v];
+	}
+	if (u > v) std::swap(u, v);
+	return permuted_view::mix((uint64_t)(uint32_t)(u) << 32 | (uint32_t)(v));
+}
+
+cert_tag certificate_kind(certificate const * cert) {
+	if (dynamic_cast<negative_cert_K4 const *>(cert)) return cert_tag::K4;
+	if (dynamic_cast<negative_cert_K23 const *>(cert)) return cert_tag::K23;
+	if (dynamic_cast<negative_cert_T4 const *>(cert)) return cert_tag::T4;
+	if (dynamic_cast<negative_cert_tri_comp_cut const *>(cert)) return cert_tag::tri_comp_cut;
+	if (dynamic_cast<negative_cert_tri_cut_comp const *>(cert)) return cert_tag::tri_cut_comp;
+	if (dynamic_cast<positive_cert_gsp const *>(cert)) return cert_tag::gsp;
+	if (dynamic_cast<positive_cert_op const *>(cert)) return cert_tag::op;
+	return cert_tag{};
+}
+
+result_summary summarize_result(gsp_sp_op_result const& result, int const * global = nullptr) { // summarize a result for a view with the given numbering (or for the host itself), in O(|V| + |E|) time
+	result_summary s;
+	s.flags = (unsigned char)((result.is_gsp ? 1 : 0) | (result.is_sp ? 2 : 0) | (result.is_op ? 4 : 0));
+	std::shared_ptr<certificate> const * reasons[3] = {&result.gsp_reason, &result.sp_reason, &result.op_reason};
+	for (int i = 0; i < 3; i++) s.reasons[i] = certificate_kind(reasons[i]->get());
+
+	for (auto reason : reasons) {
+		if (auto gsp = dynamic_cast<positive_cert_gsp const *>(reason->get()); gsp && s.tree_edges == 0) { // gsp_reason and sp_reason are usually the same tree
+			for (flat_sp_node const& node : gsp->decomposition.nodes) {
+				if (node.comp != c_type::edge) continue;
+				s.tree_edges++;
+				s.tree_hash += summary_edge_hash(node.source, node.sink, global);
+			}
+		}
+	}
+
+	if (auto op = dynamic_cast<positive_cert_op const *>(result.op_reason.get())) {
+		s.bicomps = (int)(op->boundaries.size());
+		for (std::vector<edge_t> const& boundary : op->boundaries) { // the bicomps come out in a numbering-dependent order, so each boundary is hashed on its own and the hashes added up
+			uint64_t h = 0;
+			for (edge_t e : boundary) h += summary_edge_hash(e.first, e.second, global);
+			s.boundary_hash += permuted_view::mix(h);
+		}
+	}
+
+	return s;
+}
+
+struct invariance_trial {
+	bool relabel = true;	// number the vertices at random (otherwise they keep their host numbers, apart from the root)
+	bool reorder = false;	// read the adjacency lists in a scrambled order (see permuted_view)
+	int root = -1;			// the host vertex numbered 0, where the DFS starts (-1 for whichever the numbering puts there)
+	unsigned seed = 0;
+};
+
+struct invariance_config {
+	int threads = 0;			// 0 means one per hardware thread
+	bool authenticate = false;	// also authenticate every trial's result against its view, which costs about as much again as classifying it
+};
+
+struct trial_outcome {
+	bool classified = false;	// false if the implementation threw, saying why in error
+	bool agrees = false;		// whether the summary is the reference summary
+	bool authenticated = false; // only with config.authenticate
+	result_summary summary;
+	std::string error;
+};
+
+void number_vertices(int n, invariance_trial const& trial, std::vector<int>& global, std::vector<int>& local) { // the numbering of a trial, in O(|V|) time
+	global.resize((size_t)(n));
+	local.resize((size_t)(n));
+	std::iota(global.begin(), global.end(), 0);
+	if (trial.relabel) {
+		std::mt19937 rng{trial.seed};
+		std::shuffle(global.begin(), global.end(), rng);
+	}
+	if (trial.root >= 0 && trial.root < n) std::swap(global[0], *std::find(global.begin(), global.end(), trial.root));
+	for (int v = 0; v < n; v++) local[global[v]] = v;
+}
+
+trial_outcome run_invariance_trial(graph const& g, invariance_trial const& trial, result_summary const& expected, invariance_config const& config, std::vector<int>& global, std::vector<int>& local) { // one trial, with the numbering in the caller's scratch space
+	trial_outcome out;
+	number_vertices(g.n, trial, global, local);
+	permuted_view view{&g, g.n, g.e, global.data(), local.data(), trial.reorder ? permuted_view::mix(trial.seed) | 1 : 0};
+
+	try {
+		gsp_sp_op_result result = GSP_SP_OP(view);
+		out.classified = true;
+		out.summary = summarize_result(result, global.data());
+		out.agrees = out.summary == expected;
+		if (config.authenticate) out.authenticated = result.authenticate(view);
+	} catch (std::exception const& ex) {
+		out.error = ex.what();
+	} catch (...) {
+		out.error = "unknown exception during classification";
+	}
+
+	return out;
+}
+
+std::vector<trial_outcome> run_invariance_trials(graph const& g, result_summary const& expected, std::vector<invariance_trial> const& trials, invariance_config config = {}) { // run every trial and compare it with expected (usually the summary of the authenticated result on g itself), outcomes in the order of the trials
+																																													  // workers take trials off a shared counter, like classify_subgraphs (see subgraph-batch.hxx)
+	std::vector<trial_outcome> outcomes(trials.size());
+	if (config.threads <= 0) config.threads = std::max(1, (int)(std::thread::hardware_concurrency()));
+	config.threads = (int)(std::min((size_t)(config.threads), std::max(trials.size(), (size_t)(1))));
+
+	std::atomic<size_t> next{0};
+	auto work = [&] {
+		std::vector<int> global, local;
+		for (size_t i = next++; i < trials.size(); i = next++) {
+			outcomes[i] = run_invariance_trial(g, trials[i], expected, config, global, local);
+		}
+	};
+
+	if (config.threads == 1) { // no point starting a thread just to wait for it
+		work();
+		return outcomes;
+	}
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < config.threads; t++) threads.emplace_back(work);
+	for (std::thread& t : threads) t.join();
+
+	return outcomes;
+}
+
+#endif
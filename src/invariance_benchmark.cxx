@@ -0,0 +1,106 @@
+// this runs the same invariance trials on a few large workloads (see workload-generators.hxx) three ways: the old way, copying the graph for every trial and authenticating each result; through permuted_views one trial after another, comparing result summaries; and through run_invariance_trials on every hardware thread
+// each trial numbers the vertices at random, and every other one also scrambles the adjacency lists; the copies are built the way the testers used to build them (relabelled edge by edge, then normalized), the views only need two arrays of |V| ints
+// optional command line arguments: the order of the graphs (default 200000) and the number of trials (default 8)
+
+#include "gsp-sp-op.hxx"
+#include "graph-normalization.hxx"
+#include "invariance-trials.hxx"
+#include "workload-generators.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+graph copy_trial(graph const& g, invariance_trial const& trial) { // the baseline: a copy of g numbered as the trial's view numbers it, with its adjacency lists shuffled if the trial reorders them
+	std::vector<int> global, local;
+	number_vertices(g.n, trial, global, local);
+	graph out{g.n, g.e, std::vector<std::vector<int>>((size_t)(g.n))};
+	for (int u = 0; u < g.n; u++) {
+		for (int v : g.adjLists[u]) {
+			if (u < v) out.add_edge(local[u], local[v]);
+		}
+	}
+	normalize_graph(out);
+	if (trial.reorder) {
+		std::mt19937 rng{trial.seed};
+		for (std::vector<int>& list : out.adjLists) std::shuffle(list.begin(), list.end(), rng);
+	}
+	return out;
+}
+
+size_t graph_bytes(graph const& g) {
+	size_t bytes = sizeof(graph) + g.adjLists.capacity() * sizeof(std::vector<int>);
+	for (std::vector<int> const& list : g.adjLists) bytes += list.capacity() * sizeof(int);
+	return bytes;
+}
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 200000;
+	int count = argc > 2 ? std::atoi(argv[2]) : 8;
+	int threads = std::max(1, (int)(std::thread::hardware_concurrency()));
+
+	std::vector<std::pair<std::string, std::function<graph()>>> workloads = {
+		{"random GSP", [&] {return random_gsp_graph(n, 40);}},
+		{"outerplanar", [&] {return random_outerplanar_graph(n, 40);}},
+		{"block chain, 3-10", [&] {return block_chain(n / 6, 3, 10, 40);}},
+		{"100 fans", [&] {return hub_graph(n, 100, true, 40);}},
+		{"T4 at depth " + std::to_string(n / 2), [&] {return planted_obstruction(n, obstruction::T4, n / 2, 40);}},
+	};
+
+	std::vector<invariance_trial> trials;
+	for (int t = 0; t < count; t++) trials.push_back({true, t % 2 == 1, -1, (unsigned)(t + 1)});
+
+	bool ok = true;
+	std::cout << "parallel trials run on " << threads << " thread" << (threads == 1 ? "" : "s") << "\n" << std::fixed << std::setprecision(3);
+
+	for (auto const& [name, make] : workloads) {
+		graph const g = make();
+		gsp_sp_op_result base = GSP_SP_OP(g);
+		if (!base.authenticate(g)) {
+			std::cout << name << ": the reference result did not authenticate\n";
+			ok = false;
+			continue;
+		}
+		result_summary expected = summarize_result(base);
+
+		bool copies_agree = true;
+		size_t copy_bytes = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (invariance_trial const& trial : trials) {
+			graph copy = copy_trial(g, trial);
+			copy_bytes = std::max(copy_bytes, graph_bytes(copy));
+			gsp_sp_op_result r = GSP_SP_OP(copy);
+			copies_agree = copies_agree && r.is_gsp == base.is_gsp && r.is_sp == base.is_sp && r.is_op == base.is_op && r.authenticate(copy);
+		}
+		double copy_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		std::vector<trial_outcome> sequential = run_invariance_trials(g, expected, trials, {1});
+		double view_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		std::vector<trial_outcome> parallel = run_invariance_trials(g, expected, trials, {threads});
+		double parallel_time = seconds_since(start);
+
+		bool views_agree = true;
+		for (size_t t = 0; t < trials.size(); t++) views_agree = views_agree && sequential[t].agrees && parallel[t].agrees;
+
+		std::cout << std::left << std::setw(20) << name << std::right << std::setw(8) << g.n << " vertices " << std::setw(8) << g.e << " edges, " << count << " trials: "
+				  << "copies " << copy_time << "s (" << copy_bytes / 1024 << " KiB each), views " << view_time << "s (" << 2 * sizeof(int) * (size_t)(g.n) / 1024 << " KiB each, "
+				  << std::setprecision(2) << copy_time / view_time << "x), parallel " << std::setprecision(3) << parallel_time << "s\n";
+
+		if (!copies_agree || !views_agree) {
+			std::cout << "  " << (!copies_agree ? "a copy" : "a view") << " disagreed with the reference result\n";
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// this times normalize_graph (see graph-normalization.hxx) on one thread and on every hardware thread against the obvious alternative of sorting every adjacency list and removing adjacent repeats, followed by a BFS for connectivity
+// the input is a random connected graph (a random tree plus random chords) with a few percent of its edges doubled and some self-loops added, shuffled into its adjacency lists; every approach must agree on the edges that are left and on the number of components
+// optional command line argument: the order of the graph (default 2000000)
+
+#include "graph-normalization.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+graph noisy_graph(int n, unsigned seed) { // a random tree with n / 2 random chords, 5% of all edges added a second time and n / 100 self-loops
+	std::mt19937 rng{seed};
+	std::vector<edge_t> edges;
+	for (int v = 1; v < n; v++) edges.emplace_back((int)(rng() % v), v);
+	for (int i = 0; i < n / 2; i++) {
+		int u = (int)(rng() % n), v = (int)(rng() % n);
+		if (u != v) edges.emplace_back(u, v);
+	}
+	for (size_t i = 0, m = edges.size(); i < m / 20; i++) edges.push_back(edges[rng() % m]);
+	for (int i = 0; i < n / 100; i++) {
+		int v = (int)(rng() % n);
+		edges.emplace_back(v, v);
+	}
+	std::shuffle(edges.begin(), edges.end(), rng);
+
+	graph g{n, (int)(edges.size()), std::vector<std::vector<int>>((size_t)(n))};
+	for (edge_t e : edges) g.add_edge(e.first, e.second);
+	return g;
+}
+
+int sort_and_bfs(graph& g) { // the baseline: sort each list, drop self-loops and repeats, recount g.e, and count the components with a BFS
+	long long e = 0;
+	for (int u = 0; u < g.n; u++) {
+		std::vector<int>& list = g.adjLists[u];
+		list.erase(std::remove_if(list.begin(), list.end(), [&](int v) {return v < 0 || v >= g.n || v == u;}), list.end());
+		std::sort(list.begin(), list.end());
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+		e += (long long)(list.size());
+	}
+	g.e = (int)(e / 2);
+
+	int components = 0;
+	std::vector<char> seen((size_t)(g.n), false);
+	std::vector<int> queue;
+	for (int s = 0; s < g.n; s++) {
+		if (seen[s]) continue;
+		components++;
+		seen[s] = true;
+		queue.assign(1, s);
+		for (size_t i = 0; i < queue.size(); i++) {
+			for (int v : g.adjLists[queue[i]]) {
+				if (!seen[v]) {
+					seen[v] = true;
+					queue.push_back(v);
+				}
+			}
+		}
+	}
+	return components;
+}
+
+bool same_edges(graph const& a, graph const& sorted) { // whether a has the same (simple) adjacency lists as sorted, up to order
+	if (a.n != sorted.n || a.e != sorted.e) return false;
+	for (int v = 0; v < a.n; v++) {
+		std::vector<int> list = a.adjLists[v];
+		std::sort(list.begin(), list.end());
+		if (list != sorted.adjLists[v]) return false;
+	}
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 2000000;
+	int hardware = std::max(1, (int)(std::thread::hardware_concurrency()));
+	graph const input = noisy_graph(n, 34);
+	std::cout << "graph with " << n << " vertices and " << input.e << " edges (before normalization), " << hardware << " hardware thread" << (hardware == 1 ? "" : "s") << "\n" << std::fixed << std::setprecision(3);
+
+	graph sorted = input;
+	auto start = std::chrono::steady_clock::now();
+	int components = sort_and_bfs(sorted);
+	double sort_time = seconds_since(start);
+	std::cout << "sorting lists and BFS:     " << sort_time << "s, " << sorted.e << " edges, " << components << " component" << (components == 1 ? "" : "s") << "\n";
+
+	bool ok = true;
+	for (int threads : {1, hardware}) {
+		double best = 0;
+		for (int pass = 0; pass < 3; pass++) {
+			graph g = input;
+			start = std::chrono::steady_clock::now();
+			normalization_report report = normalize_graph(g, normalization_config{threads});
+			double time = seconds_since(start);
+			best = pass == 0 ? time : std::min(best, time);
+
+			if (pass == 0) {
+				bool same = report.components == components && same_edges(g, sorted);
+				ok = ok && same;
+				std::cout << "normalize_graph, " << std::setw(2) << report.threads << " thread" << (report.threads == 1 ? ": " : "s:") << "   ";
+				report.print(std::cout);
+				if (!same) std::cout << "  which DISAGREES with sorting\n";
+			}
+		}
+		std::cout << "  best of 3: " << best << "s (" << std::setprecision(2) << sort_time / best << "x faster than sorting)\n" << std::setprecision(3);
+		if (hardware == 1) break;
+	}
+
+	return ok ? 0 : 1;
+}
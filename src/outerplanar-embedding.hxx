@@ -0,0 +1,235 @@
+// this file contains a linear time construction of an outerplanar embedding (a rotation system) from the exterior boundaries in an OP certificate, and a linear time check that a rotation system is an outerplanar embedding of a graph
+// the boundaries only give the cycle around each biconnected component, but that's all there is to it: every chord of a bicomp runs inside its cycle, so the neighbours of a vertex inside a bicomp are in the order they come up on the cycle going around from that vertex
+// and every other bicomp at a cut vertex goes in the corner of the outer face there, so a vertex's rotation is just its neighbours in each of its bicomps, one bicomp after another
+
+#ifndef __OUTERPLANAR_EMBEDDING_HXX__
+#define __OUTERPLANAR_EMBEDDING_HXX__
+
+#include "gsp-sp-op-certificates.hxx"
+#include <algorithm>
+#include <span>
+#include <vector>
+
+struct rotation_system { // a combinatorial embedding of a graph: the neighbours of every vertex in the cyclic order they are drawn around it
+						 // stored in compressed sparse row form like packed_graph, so the embedding of a huge graph is two arrays
+	int n = 0;
+	std::vector<int> offsets{0}; // v's rotation is order[offsets[v]] up to (but not including) order[offsets[v + 1]], and wraps around from the last to the first
+	std::vector<int> order;
+
+	int degree(int v) const {return offsets[v + 1] - offsets[v];}
+	int neighbor(int v, int i) const {return order[offsets[v] + i];}
+	std::span<int const> neighbors(int v) const {return {order.data() + offsets[v], (size_t)(degree(v))};}
+};
+
+template <typename Graph>
+bool outerplanar_embedding(positive_cert_op const& cert, Graph const& g, rotation_system& out) { // build the outerplanar embedding of G the boundaries of cert describe into out in O(|V| + |E|) time, failing if they don't describe G
+																								   // cert should authenticate against G (nothing short of that makes sure every chord fits inside its cycle), but anything it trips over on the way is still reported rather than read out of bounds
+																								   // every bicomp is drawn with its cycle in the same direction, so the outer face goes around each cycle in that direction, and the rotation of a vertex starts with its successor on the cycle of each bicomp and ends with its predecessor
+	std::vector<std::vector<edge_t>> const& boundaries = cert.boundaries;
+	int const n_comps = (int)(boundaries.size());
+
+	out.n = g.n;
+	out.offsets.assign((size_t)(g.n) + 1, 0);
+	for (int v = 0; v < g.n; v++) out.offsets[v + 1] = out.offsets[v] + g.degree(v);
+	int const darts = out.offsets[g.n]; // every edge is a dart in each direction
+	out.order.assign((size_t)(darts), -1);
+
+	if (darts == 0) return g.n <= 1; // a single vertex has nothing to order (and isn't given a boundary)
+	if (n_comps == 0) return false;
+
+	std::vector<int> owner((size_t)(g.n), -1); // owner[v] is the last bicomp v is on the boundary of, which is the one it isn't the root of (bicomps come after all their children)
+	for (int cnum = 0; cnum < n_comps; cnum++) {
+		for (edge_t e : boundaries[cnum]) {
+			if (e.first < 0 || e.first >= g.n || e.second < 0 || e.second >= g.n) return false;
+			owner[e.first] = cnum;
+			owner[e.second] = cnum;
+		}
+	}
+
+	for (int v = 0; v < g.n; v++) {
+		if (owner[v] == -1) return false; // every vertex is on the exterior boundary of G
+	}
+
+	std::vector<int> base((size_t)(n_comps) + 1, 0); // the positions on the cycle of bicomp c are numbered from base[c] up to (but not including) base[c + 1]
+	std::vector<int> position((size_t)(g.n), -1);	 // position[v] is v's position on the cycle of its owner
+	std::vector<int> roots((size_t)(n_comps), -1);	 // roots[c] is the root vertex of bicomp c (the one vertex on its cycle owned by its parent), and root_position[c] its position on the cycle
+	std::vector<int> root_position((size_t)(n_comps), -1);
+	std::vector<int> cycle_adjs((size_t)(2 * g.n), -1); // the two neighbours of a vertex on the cycle of the bicomp being numbered, cleared again after every bicomp so each one costs only its own size
+
+	auto place = [&](int cnum, int v, int p) { // give v position p on the cycle of bicomp cnum
+		if (owner[v] == cnum) {
+			position[v] = p;
+			return true;
+		}
+		if (roots[cnum] != -1) return false; // a second vertex owned by another bicomp
+		roots[cnum] = v;
+		root_position[cnum] = p;
+		return true;
+	};
+
+	for (int cnum = 0; cnum < n_comps; cnum++) {
+		std::vector<edge_t> const& boundary = boundaries[cnum];
+		int const size = (int)(boundary.size());
+		if (size == 0) return false;
+
+		if (size == 1) { // a bridge is a cycle of length 2 as far as positions go
+			if (boundary[0].first == boundary[0].second || !place(cnum, boundary[0].first, 0) || !place(cnum, boundary[0].second, 1)) return false;
+			base[cnum + 1] = base[cnum] + 2;
+			continue;
+		}
+
+		for (edge_t e : boundary) {
+			int * a = &cycle_adjs[2 * e.first];
+			int * b = &cycle_adjs[2 * e.second];
+			if (a[1] != -1 || b[1] != -1) return false; // a third boundary edge at a vertex, so it isn't a cycle
+			a[a[0] == -1 ? 0 : 1] = e.second;
+			b[b[0] == -1 ? 0 : 1] = e.first;
+		}
+
+		int const start = boundary[0].first;
+		int prev = -1, curr = start, length = 0;
+		do { // walk around the cycle numbering it, which has to take exactly one step per boundary edge
+			if (length == size || cycle_adjs[2 * curr + 1] == -1 || !place(cnum, curr, length)) return false;
+			int next = cycle_adjs[2 * curr] != prev ? cycle_adjs[2 * curr] : cycle_adjs[2 * curr + 1];
+			prev = curr;
+			curr = next;
+			length++;
+		} while (curr != start);
+		if (length != size) return false;
+
+		for (edge_t e : boundary) {
+			cycle_adjs[2 * e.first] = cycle_adjs[2 * e.first + 1] = -1;
+			cycle_adjs[2 * e.second] = cycle_adjs[2 * e.second + 1] = -1;
+		}
+		base[cnum + 1] = base[cnum] + size;
+	}
+
+	for (int cnum = 0; cnum < n_comps - 1; cnum++) {
+		if (roots[cnum] == -1) return false; // every bicomp but the last hangs off of its parent
+	}
+
+	auto position_in = [&](int cnum, int v) {return v == roots[cnum] ? root_position[cnum] : position[v];};
+
+	// every dart x -> w puts x into w's rotation; a counting sort of the darts by their bicomp, and then by how far around its cycle from w they reach x, puts every rotation in order at once
+	std::vector<int> slot((size_t)(darts));		// slot[d] is the sort key of dart d (the ith dart out of x is d = offsets[x] + i)
+	std::vector<int> heads((size_t)(darts));
+	std::vector<int> count((size_t)(base[n_comps]) + 1, 0);
+	for (int x = 0; x < g.n; x++) {
+		int d = out.offsets[x];
+		for (int w : g.neighbors(x)) {
+			if (w < 0 || w >= g.n) return false;
+
+			int cnum; // the bicomp edge xw is in: the owner of both endpoints, or otherwise the owner of the one whose bicomp the other is the root of
+			if (owner[x] == owner[w]) {
+				cnum = owner[x];
+			} else if (roots[owner[w]] == x) {
+				cnum = owner[w];
+			} else if (roots[owner[x]] == w) {
+				cnum = owner[x];
+			} else {
+				return false; // the edge isn't in any bicomp
+			}
+
+			int const size = base[cnum + 1] - base[cnum];
+			int const offset = (position_in(cnum, x) - position_in(cnum, w) + size) % size;
+			if (offset == 0) return false; // a self-loop
+			slot[d] = base[cnum] + offset;
+			heads[d] = w;
+			count[slot[d] + 1]++;
+			d++;
+		}
+	}
+
+	for (size_t i = 1; i < count.size(); i++) count[i] += count[i - 1];
+
+	std::vector<int> sorted((size_t)(darts)); // the darts in order of their keys
+	for (int d = 0; d < darts; d++) sorted[count[slot[d]]++] = d;
+
+	std::vector<int> tails((size_t)(darts));
+	for (int x = 0; x < g.n; x++) std::fill(tails.begin() + out.offsets[x], tails.begin() + out.offsets[x + 1], x);
+
+	std::vector<int> fill(out.offsets.begin(), out.offsets.end() - 1); // where the next neighbour of each vertex goes in its rotation
+	for (int d : sorted) out.order[fill[heads[d]]++] = tails[d]; // the darts into each head come out bicomp by bicomp, each bicomp's in order around its cycle, and the order of the bicomps doesn't matter since they meet at the vertex only
+
+	for (int v = 0; v < g.n; v++) {
+		if (fill[v] != out.offsets[v + 1]) return false; // G isn't symmetric, so some vertex got more tails than it has neighbours
+	}
+
+	return true;
+}
+
+template <typename Graph>
+bool trace_faces(rotation_system const& r, Graph const& g, int& faces, int& widest) { // check that r orders exactly the neighbours of every vertex of G, and count the faces of the embedding, and the most distinct vertices on any one face, in O(|V| + |E|) time
+	if (r.n != g.n || (int)(r.offsets.size()) != g.n + 1 || r.offsets[0] != 0) return false;
+
+	std::vector<int> mark((size_t)(g.n), -1); // mark[u] is v while checking v's rotation if u is a neighbour of v, and g.n + v once it has been seen in the rotation
+	for (int v = 0; v < g.n; v++) {
+		if (r.offsets[v + 1] - r.offsets[v] != g.degree(v)) return false;
+		for (int u : g.neighbors(v)) mark[u] = v;
+		for (int u : r.neighbors(v)) {
+			if (u < 0 || u >= g.n || mark[u] != v) return false; // not a neighbour, or there twice
+			mark[u] = g.n + v;
+		}
+	}
+
+	faces = widest = 0;
+	int const darts = r.offsets[g.n];
+	if (darts == 0) { // an isolated vertex is a face of its own
+		faces = std::min(g.n, 1);
+		widest = std::min(g.n, 1);
+		return true;
+	}
+	if (darts % 2 != 0) return false;
+
+	// find the reverse of every dart: bucket the darts stably by head and then again by tail, and the ith dart of the first order is the reverse of the ith of the second, since the heads and tails of all the darts are the tails and heads of their reverses
+	std::vector<int> by_head((size_t)(darts)), by_tail((size_t)(darts)), start((size_t)(g.n) + 1, 0);
+	for (int d = 0; d < darts; d++) start[r.order[d] + 1]++;
+	for (int v = 0; v < g.n; v++) start[v + 1] += start[v];
+	for (int d = 0; d < darts; d++) by_head[start[r.order[d]]++] = d; // darts sorted by (head, tail), since they're numbered by tail
+
+	std::vector<int> tails((size_t)(darts));
+	for (int v = 0; v < g.n; v++) std::fill(tails.begin() + r.offsets[v], tails.begin() + r.offsets[v + 1], v);
+
+	std::vector<int> fill(r.offsets.begin(), r.offsets.end() - 1);
+	for (int d : by_head) by_tail[fill[tails[d]]++] = d; // darts sorted by (tail, head)
+
+	std::vector<int> reverse((size_t)(darts));
+	for (int i = 0; i < darts; i++) {
+		if (tails[by_tail[i]] != r.order[by_head[i]] || r.order[by_tail[i]] != tails[by_head[i]]) return false; // (can't happen once every rotation matched G, unless G isn't symmetric)
+		reverse[by_head[i]] = by_tail[i];
+	}
+
+	// trace the faces: after going along a dart into v, a face leaves v along the dart after its reverse in v's rotation
+	std::vector<char> traced((size_t)(darts), 0);
+	std::vector<int> on_face((size_t)(g.n), -1); // on_face[v] is the last face v was seen on, so every face counts its distinct vertices in its own length
+	for (int first = 0; first < darts; first++) {
+		if (traced[first]) continue;
+
+		int vertices = 0;
+		for (int d = first; !traced[d];) {
+			traced[d] = 1;
+			int v = r.order[d];
+			if (on_face[v] != faces) {
+				on_face[v] = faces;
+				vertices++;
+			}
+
+			int const back = reverse[d] - r.offsets[v];
+			d = r.offsets[v] + (back + 1) % (r.offsets[v + 1] - r.offsets[v]);
+		}
+
+		widest = std::max(widest, vertices);
+		faces++;
+	}
+
+	return true;
+}
+
+template <typename Graph>
+bool verify_outerplanar_embedding(rotation_system const& r, Graph const& g) { // check that r is an outerplanar embedding of G, which has to be connected, in O(|V| + |E|) time
+																			  // tracing its faces has to give |E| - |V| + 2 of them (so it's planar, by Euler's formula) with one going through every vertex (so it's outerplanar, and G is connected)
+	int faces, widest;
+	return g.n > 0 && trace_faces(r, g, faces, widest) && g.n - r.offsets[g.n] / 2 + faces == 2 && widest == g.n;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// this builds the outerplanar embedding of one large random outerplanar graph from its OP certificate (see outerplanar-embedding.hxx), and compares that with classifying the graph and with a general planar embedding of it (Boost's Boyer-Myrvold, when Boost is installed)
+// the graph is grown from an edge by putting a triangle or a quadrilateral on an edge of the outer face or hanging a new vertex off of one, so it has chords, bridges and cut vertices everywhere
+// every embedding is checked with verify_outerplanar_embedding, and Boyer-Myrvold's is checked to be a planar embedding of the graph too (it needn't be outerplanar)
+// optional command line argument: the order of the graph (default 1000000)
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "outerplanar-embedding.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if __has_include(<boost/graph/boyer_myrvold_planar_test.hpp>)
+#define __HAVE_BOOST_PLANARITY__
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/boyer_myrvold_planar_test.hpp>
+#endif
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	graph const g = random_outerplanar_graph(n, 37);
+	std::cout << "random outerplanar graph with " << g.n << " vertices and " << g.e << " edges\n" << std::fixed << std::setprecision(3);
+
+	auto start = std::chrono::steady_clock::now();
+	gsp_sp_op_result r = GSP_SP_OP(g);
+	double classify_time = seconds_since(start);
+	auto op = std::dynamic_pointer_cast<positive_cert_op>(r.op_reason);
+	if (!op) {
+		std::cout << "the graph was not classified as OP\n";
+		return 1;
+	}
+	std::cout << "classifying:                    " << classify_time << "s (" << op->boundaries.size() << " bicomps)\n";
+
+	start = std::chrono::steady_clock::now();
+	bool authentic = op->authenticate(g);
+	std::cout << "authenticating the certificate: " << seconds_since(start) << "s\n";
+
+	rotation_system embedding;
+	start = std::chrono::steady_clock::now();
+	bool built = outerplanar_embedding(*op, g, embedding);
+	std::cout << "outerplanar embedding:          " << seconds_since(start) << "s\n";
+
+	start = std::chrono::steady_clock::now();
+	bool verified = built && verify_outerplanar_embedding(embedding, g);
+	std::cout << "verifying it:                   " << seconds_since(start) << "s\n";
+
+	if (!authentic || !verified) {
+		std::cout << (!authentic ? "the certificate did not authenticate\n" : !built ? "the embedding could not be built\n" : "the embedding did not verify\n");
+		return 1;
+	}
+
+#ifdef __HAVE_BOOST_PLANARITY__
+	using boost_graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS, boost::property<boost::vertex_index_t, int>, boost::property<boost::edge_index_t, int>>;
+	using boost_edge = boost::graph_traits<boost_graph>::edge_descriptor;
+
+	start = std::chrono::steady_clock::now();
+	boost_graph bg{(size_t)(g.n)};
+	int index = 0;
+	for (int u = 0; u < g.n; u++) {
+		for (int v : g.neighbors(u)) {
+			if (u < v) boost::put(boost::edge_index, bg, boost::add_edge(u, v, bg).first, index++);
+		}
+	}
+	std::cout << "copying into a Boost graph:     " << seconds_since(start) << "s\n";
+
+	std::vector<std::vector<boost_edge>> boost_embedding((size_t)(g.n));
+	start = std::chrono::steady_clock::now();
+	bool planar = boost::boyer_myrvold_planarity_test(boost::boyer_myrvold_params::graph = bg, boost::boyer_myrvold_params::embedding = &boost_embedding[0]);
+	double boost_time = seconds_since(start);
+	std::cout << "Boyer-Myrvold planar embedding: " << boost_time << "s\n";
+
+	rotation_system general; // Boyer-Myrvold's embedding as a rotation system, to check it with the same face tracing (minus the outer face check)
+	general.n = g.n;
+	general.offsets.assign((size_t)(g.n) + 1, 0);
+	for (int v = 0; v < g.n; v++) {
+		general.offsets[v + 1] = general.offsets[v] + (int)(boost_embedding[v].size());
+		for (boost_edge e : boost_embedding[v]) {
+			int u = (int)(boost::source(e, bg)) == v ? (int)(boost::target(e, bg)) : (int)(boost::source(e, bg));
+			general.order.push_back(u);
+		}
+	}
+	int faces, widest;
+	if (!planar || !trace_faces(general, g, faces, widest) || g.n - g.e + faces != 2) {
+		std::cout << "Boyer-Myrvold did not embed the graph\n";
+		return 1;
+	}
+#else
+	std::cout << "Boost isn't installed, so there's no general planar embedding to compare with\n";
+#endif
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+// this file contains a graph type with all of its adjacency lists packed into one array, for classifying large graphs
+// a graph keeps every adjacency list in a separate small allocation scattered over the heap, so the DFS touches a new page for nearly every vertex it visits; a packed_graph keeps them in two arrays allocated with storage_allocator (see page-allocator.hxx), which can be backed by huge pages on the classifying thread's NUMA node
+
+#ifndef __PACKED_GRAPH_HXX__
+#define __PACKED_GRAPH_HXX__
+
+#include "graph.hxx"
+#include <ostream>
+#include <span>
+#include <vector>
+
+struct packed_graph { // a graph in compressed sparse row form
+					  // it presents the same interface as graph (see graph.hxx), and keeps the vertex numbers and adjacency list order of the graph it was built from, so the implementation produces exactly the same result on it
+	int n;
+	int e;
+	std::vector<int, storage_allocator<int>> offsets; // v's adjacency list is targets[offsets[v]] up to (but not including) targets[offsets[v + 1]]
+	std::vector<int, storage_allocator<int>> targets;
+
+	explicit packed_graph(graph const& g) : n{g.n}, e{g.e}, offsets((size_t)(g.n) + 1) { // copy g, which is built by whichever thread calls this (and so placed on its node)
+		offsets[0] = 0;
+		for (int v = 0; v < n; v++) offsets[v + 1] = offsets[v] + g.degree(v);
+
+		targets.resize((size_t)(offsets[n]));
+		for (int v = 0; v < n; v++) {
+			std::copy(g.adjLists[v].begin(), g.adjLists[v].end(), targets.begin() + offsets[v]);
+		}
+	}
+
+	int degree(int v) const {return offsets[v + 1] - offsets[v];}
+	int neighbor(int v, int i) const {return targets[offsets[v] + i];}
+	std::span<int const> neighbors(int v) const {return {targets.data() + offsets[v], (size_t)(degree(v))};}
+
+	bool adjacent(int e1, int e2) const { // check if two vertices are adjacent (O|deg(v)| time)
+		for (int v : neighbors(e1)) {
+			if (v == e2) return true;
+		}
+
+		return false;
+	}
+
+	void output_adj_list(int v, std::ostream& os) const {
+		os << "vertex " << v << " adjacencies: ";
+
+		for (int v2 : neighbors(v)) {
+			os << v2 << " ";
+		}
+
+		os << "\n";
+	}
+};
+
+std::ostream& operator<<(std::ostream& os, packed_graph const& g) { // output a packed graph (for debugging purposes)
+	os << "Packed graph with " << g.n << " vertices and " << g.e << " edges:\n";
+
+	for (int i = 0; i < g.n; i++) {
+		g.output_adj_list(i, os);
+	}
+
+	return os;
+}
+
+#endif
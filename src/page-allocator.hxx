@@ -0,0 +1,133 @@
+// this file contains the allocator behind storage_allocator, which the implementation's per-vertex arrays and DFS stacks (see graph_storage in graph.hxx) and packed_graph's adjacency storage (see packed-graph.hxx) are allocated with
+// by default storage_allocator is std::allocator; compiling with -D__PAGE_ALLOCATOR__ makes it page_allocator, which maps large arrays directly so they can be backed by huge pages and placed on the NUMA node of the thread running the classification
+// every part of that is best effort: without explicit huge pages reserved it uses transparent ones, without NUMA support (or off Linux altogether) it leaves placement to the system, and small arrays always come from operator new
+
+#ifndef __PAGE_ALLOCATOR_HXX__
+#define __PAGE_ALLOCATOR_HXX__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum class huge_page_mode {
+	none,			// small pages only (mappings are marked MADV_NOHUGEPAGE, so even a system with transparent huge pages always on leaves them alone)
+	transparent,	// ask for transparent huge pages with MADV_HUGEPAGE, which the kernel grants if it can find free 2 MiB pages
+	explicit_pages	// map from the reserved hugetlbfs pool (vm.nr_hugepages) with MAP_HUGETLB, falling back to transparent if the pool is empty
+};
+
+struct page_policy {
+	huge_page_mode huge_pages = huge_page_mode::transparent;
+	bool numa_local = true; // bind each mapping to the NUMA node the allocating thread is running on (preferred, so it still spills over to other nodes rather than failing)
+};
+
+struct page_allocation_stats { // what page_allocator actually got, since it falls back quietly
+	std::atomic<long> mappings{0};			// arrays that were mapped directly rather than coming from operator new
+	std::atomic<long> explicit_pages{0};	// of which were backed by the hugetlbfs pool
+	std::atomic<long> numa_bound{0};		// of which were bound to the allocating thread's node
+};
+
+constexpr size_t huge_page_size = size_t{2} << 20; // arrays of at least this many bytes are mapped, in multiples of it
+
+page_policy& page_allocation_policy() { // the policy for every mapping made from now on; set it before classifying, not while a classification is running
+	static page_policy policy;
+	return policy;
+}
+
+page_allocation_stats& page_allocation_counters() {
+	static page_allocation_stats stats;
+	return stats;
+}
+
+#ifdef __linux__
+void * map_pages(size_t length) { // map length bytes (a multiple of huge_page_size) according to the policy, throwing std::bad_alloc if even a plain mapping fails
+	page_policy const policy = page_allocation_policy();
+	page_allocation_stats& stats = page_allocation_counters();
+	void * block = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+	if (policy.huge_pages == huge_page_mode::explicit_pages) {
+		block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (block != MAP_FAILED) stats.explicit_pages++;
+	}
+#endif
+
+	if (block == MAP_FAILED) { // map an extra huge page's worth and trim both ends, so the block starts on a huge page boundary and transparent huge pages can cover all of it
+		char * raw = (char *)(mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+		if (raw == MAP_FAILED) throw std::bad_alloc{};
+
+		size_t head = (huge_page_size - (size_t)((uintptr_t)(raw) % huge_page_size)) % huge_page_size;
+		if (head > 0) munmap(raw, head);
+		munmap(raw + head + length, huge_page_size - head);
+		block = raw + head;
+
+#ifdef MADV_HUGEPAGE
+		madvise(block, length, policy.huge_pages == huge_page_mode::none ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+#endif
+	}
+
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+	unsigned cpu = 0, node = 0;
+	if (policy.numa_local && syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && node < 64) { // nothing has touched the block yet, so binding it now decides where every page of it goes
+		unsigned long nodes = 1ul << node;
+		if (syscall(SYS_mbind, block, length, 1 /* MPOL_PREFERRED */, &nodes, 8 * sizeof(nodes) + 1, 0) == 0) stats.numa_bound++;
+	}
+#endif
+
+	stats.mappings++;
+	return block;
+}
+#endif
+
+template <typename T>
+struct page_allocator { // a stateless allocator that maps arrays of at least huge_page_size bytes according to page_allocation_policy(), and gets everything smaller from operator new
+						// whether a block was mapped depends only on its size, so deallocate can tell without any bookkeeping
+	using value_type = T;
+
+	page_allocator() {}
+	template <typename U>
+	page_allocator(page_allocator<U> const&) {}
+
+	static bool mapped(size_t bytes) {return bytes >= huge_page_size;} // (only on Linux; placement is left to the system everywhere else)
+
+	static size_t mapping_length(size_t bytes) {return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;}
+
+	T * allocate(size_t count) {
+		size_t bytes = count * sizeof(T);
+#ifdef __linux__
+		if (mapped(bytes)) return (T *)(map_pages(mapping_length(bytes)));
+#endif
+		return std::allocator<T>{}.allocate(count);
+	}
+
+	void deallocate(T * block, size_t count) {
+		size_t bytes = count * sizeof(T);
+#ifdef __linux__
+		if (mapped(bytes)) {
+			munmap(block, mapping_length(bytes));
+			return;
+		}
+#endif
+		std::allocator<T>{}.deallocate(block, count);
+	}
+
+	template <typename U>
+	bool operator==(page_allocator<U> const&) const {return true;}
+};
+
+#ifdef __PAGE_ALLOCATOR__
+template <typename T>
+using storage_allocator = page_allocator<T>;
+#else
+template <typename T>
+using storage_allocator = std::allocator<T>;
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+// this classifies one large random GSP graph as a graph and as a packed_graph (see packed-graph.hxx), with the implementation's per-vertex arrays and the packed adjacency storage allocated on small pages, on transparent huge pages and on explicit huge pages (see page-allocator.hxx)
+// it reports the best of a few runs of each, the number of data TLB misses (when the kernel lets us count them with perf_event_open), and what the allocator actually got, since it falls back quietly when e.g. no explicit huge pages are reserved
+// every run must produce the same certificates; the packed runs are authenticated against the packed_graph too
+// optional command line argument: the order of the graph (default 2000000)
+
+#ifndef __PAGE_ALLOCATOR__
+#define __PAGE_ALLOCATOR__ // the benchmark is only meaningful with the page allocator compiled in, so it always is
+#endif
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "gsp-sp-op-serialization.hxx"
+#include "packed-graph.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#endif
+
+struct tlb_counter { // counts data TLB load misses of this thread, if perf_event_open is allowed
+	int fd = -1;
+
+	tlb_counter() {
+#ifdef __linux__
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+
+	~tlb_counter() {
+		if (fd != -1) close(fd);
+	}
+
+	void start() {
+#ifdef __linux__
+		if (fd == -1) return;
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	long long stop() { // the misses since start, or -1 if they can't be counted
+		long long count = -1;
+#ifdef __linux__
+		if (fd == -1 || ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) != 0 || read(fd, &count, sizeof(count)) != (ssize_t)(sizeof(count))) count = -1;
+#endif
+		return count;
+	}
+};
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 2000000;
+	graph const g = random_gsp_graph(n, 35);
+	std::cout << "random GSP graph with " << g.n << " vertices and " << g.e << " edges\n" << std::fixed;
+
+	std::vector<unsigned char> expected;
+	serialize_result(gsp_sp_op_direct(g), expected);
+	bool ok = true;
+	tlb_counter tlb;
+
+	char const * mode_names[3] = {"small pages    ", "transparent    ", "explicit       "};
+	for (int packed = 0; packed < 2; packed++) {
+		for (int mode = 0; mode < 3; mode++) {
+			page_allocation_policy().huge_pages = (huge_page_mode)(mode);
+			page_allocation_stats& stats = page_allocation_counters();
+			stats.mappings = stats.explicit_pages = stats.numa_bound = 0;
+
+			double best = 0;
+			long long misses = -1;
+			for (int pass = 0; pass < 3; pass++) {
+				auto start = std::chrono::steady_clock::now();
+				tlb.start();
+				gsp_sp_op_result r = packed ? gsp_sp_op_direct(packed_graph{g}) : gsp_sp_op_direct(g); // the packed runs include packing the graph
+				long long pass_misses = tlb.stop();
+				double time = seconds_since(start);
+				if (pass == 0 || time < best) {
+					best = time;
+					misses = pass_misses;
+				}
+
+				if (pass == 0) {
+					std::vector<unsigned char> bytes;
+					serialize_result(r, bytes);
+					if (bytes != expected) ok = false;
+					if (packed && !r.authenticate(packed_graph{g})) ok = false;
+				}
+			}
+
+			std::cout << (packed ? "packed_graph, " : "graph,        ") << mode_names[mode] << std::setprecision(3) << best << "s, "
+					  << (misses == -1 ? std::string{"dTLB misses n/a"} : std::to_string(misses) + " dTLB misses") << " (" << stats.mappings / 3 << " mappings per run, "
+					  << stats.explicit_pages / 3 << " explicit, " << stats.numa_bound / 3 << " NUMA bound)\n";
+		}
+	}
+
+	if (!ok) std::cout << "the runs produced different certificates\n";
+	return ok ? 0 : 1;
+}
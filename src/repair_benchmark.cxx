@@ -0,0 +1,87 @@
+// this repairs a few large graphs with obstructions in them (see edge-repair.hxx) twice: with repair_graph, and with the loop it replaces, which classifies the whole graph, removes an edge of the obstruction it gives and starts over
+// the graphs are workloads from workload-generators.hxx and generate_graph, most with random chords added (by with_chords) between vertices a few steps apart, which make K4s (and K23s) all over them; both ways pick the edge to remove from an obstruction the same way, so they remove about as many edges
+// both results are checked: every edge removed must have been in the graph, and the final certificate must authenticate against the graph without them
+// optional command line arguments: the order of the graphs (default 100000) and a seed (default 41)
+
+#include "gsp-sp-op.hxx"
+#include "GraphGenerator.hxx"
+#include "edge-repair.hxx"
+#include "workload-generators.hxx"
+#include "benchmark-util.hxx"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+repair_result repair_by_rerunning(graph const& g, repair_target target) { // the baseline: classify the whole graph again after every edge removed
+	repair_result out{false, {}, {}, g};
+	while (true) {
+		out.result = GSP_SP_OP(out.g);
+		out.classifications++;
+		out.classified_size += out.g.n + out.g.e;
+		certificate const * cert = repair_obstruction(out.result, target);
+		if (!cert) break;
+		edge_t e = obstruction_edge(cert);
+		remove_edge(out.g, e.first, e.second);
+		out.removed.push_back(e);
+	}
+	out.repaired = true;
+	return out;
+}
+
+bool check(graph const& g, repair_result const& r, repair_target target) { // whether r is a valid repair of g
+	if (!r.repaired || r.g.e != g.e - (int)(r.removed.size())) return false;
+	for (edge_t e : r.removed) {
+		if (!g.adjacent(e.first, e.second) || r.g.adjacent(e.first, e.second)) return false;
+	}
+	return (target == repair_target::gsp ? r.result.is_gsp : r.result.is_op) && r.result.authenticate(r.g);
+}
+
+struct workload {
+	std::string name;
+	std::function<graph()> make;
+	repair_target target;
+};
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 100000;
+	unsigned seed = argc > 2 ? (unsigned)(std::atoi(argv[2])) : 41;
+
+	std::vector<workload> workloads = {
+		{"T4 (nothing to do)", [&] {return planted_obstruction(n, obstruction::T4, n / 2, seed);}, repair_target::gsp},
+		{"K4 at depth " + std::to_string(n / 2), [&] {return planted_obstruction(n, obstruction::K4, n / 2, seed);}, repair_target::gsp},
+		{"block tree + chords", [&] {return with_chords(block_tree(n / 6, 3, 10, seed), n / 500, seed);}, repair_target::gsp},
+		{"random GSP + chords", [&] {return with_chords(random_gsp_graph(n, seed), n / 500, seed);}, repair_target::gsp},
+		{"generate_graph, K5s", [&] {return generate_graph(n / 40, 30, n / 400, 5, 0, seed);}, repair_target::gsp},
+		{"outerplanar + chords", [&] {return with_chords(random_outerplanar_graph(n, seed), n / 500, seed);}, repair_target::op},
+		{"random GSP, to OP", [&] {return random_gsp_graph(n / 10, seed);}, repair_target::op},
+	};
+
+	bool ok = true;
+	std::cout << std::fixed << std::setprecision(3);
+	for (workload const& w : workloads) {
+		graph const g = w.make();
+
+		auto start = std::chrono::steady_clock::now();
+		repair_result repaired = repair_graph(g, {w.target});
+		double repair_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		repair_result rerun = repair_by_rerunning(g, w.target);
+		double rerun_time = seconds_since(start);
+
+		std::cout << std::left << std::setw(22) << w.name << std::right << std::setw(8) << g.n << " vertices " << std::setw(8) << g.e << " edges, to " << (w.target == repair_target::gsp ? "GSP" : "OP ") << ": "
+				  << "repair " << repaired.removed.size() << " edges in " << repair_time << "s (" << repaired.classifications << " classifications, " << std::setprecision(1) << (double)(repaired.classified_size) / (g.n + g.e) << "x the graph), " << std::setprecision(3)
+				  << "rerunning " << rerun.removed.size() << " edges in " << rerun_time << "s (" << std::setprecision(1) << (double)(rerun.classified_size) / (g.n + g.e) << "x the graph), " << std::setprecision(2) << rerun_time / repair_time << "x\n" << std::setprecision(3);
+
+		if (!check(g, repaired, w.target) || !check(g, rerun, w.target)) {
+			std::cout << "  " << (!check(g, repaired, w.target) ? "repair_graph" : "rerunning") << " did not give a valid repair" << (repaired.error.empty() ? "" : ": " + repaired.error) << "\n";
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// this file contains a small coroutine type for long-running computations that can be suspended after a bounded amount of work and resumed later, and the meter they use to count that work
+
+#ifndef __RESUMABLE_HXX__
+#define __RESUMABLE_HXX__
+
+#include <cassert>
+#include <climits>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+struct work_meter { // counts units of work (roughly one per step of a DFS) done by a resumable computation, and how many it may do before it suspends
+	long long done = 0;
+	long long limit = LLONG_MAX; // the computation suspends once done reaches this; the default never suspends
+
+	bool exhausted() {return ++done >= limit;} // count one unit of work, and report whether the computation should suspend now
+};
+
+struct unmetered_work { // stands in for a work_meter when a resumable computation is run to completion in one go; it counts nothing and is never exhausted, so the checks for it compile away
+	static constexpr bool exhausted() {return false;}
+};
+
+template <typename T>
+struct resumable { // a coroutine producing a T which starts suspended, and suspends itself again (with co_await std::suspend_always{}) whenever its work_meter is exhausted
+				   // a resumable can hand its budget down to another one by passing it the same work_meter and stepping it until it finishes, suspending whenever it does
+	struct promise_type {
+		T value{};
+		std::exception_ptr error;
+
+		resumable get_return_object() {return resumable{std::coroutine_handle<promise_type>::from_promise(*this)};}
+		std::suspend_always initial_suspend() noexcept {return {};}
+		std::suspend_always final_suspend() noexcept {return {};} // stay suspended at the end so the value can still be taken
+		void return_value(T v) {value = std::move(v);}
+		void unhandled_exception() {error = std::current_exception();}
+	};
+
+	std::coroutine_handle<promise_type> handle;
+
+	resumable() : handle{nullptr} {}
+	explicit resumable(std::coroutine_handle<promise_type> handle_) : handle{handle_} {}
+
+	resumable(resumable const& other) = delete;
+	resumable& operator=(resumable const& other) = delete;
+
+	resumable(resumable&& other) : handle{other.handle} {
+		other.handle = nullptr;
+	}
+
+	resumable& operator=(resumable&& other) {
+		if (this != &other) {
+			reset();
+			handle = other.handle;
+			other.handle = nullptr;
+		}
+		return *this;
+	}
+
+	~resumable() {reset();}
+
+	bool step() { // run until the next suspension, and return whether the computation has finished; exceptions thrown by the computation are rethrown here
+		if (!handle) return true; // reset (or moved from), so there's nothing left to run
+		if (!handle.done()) handle.resume();
+		if (handle.promise().error) std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+		return handle.done();
+	}
+
+	bool done() const {return !handle || handle.done();}
+	T take() { // the value, once step() has returned true; a reset (or moved from) resumable has no value to take, which debug builds check
+		assert(handle && handle.done());
+		return std::move(handle.promise().value);
+	}
+
+	void reset() { // destroy the computation, wherever it is suspended; everything it had allocated is freed by the destructors of its locals
+		if (handle) handle.destroy();
+		handle = nullptr;
+	}
+};
+
+#endif
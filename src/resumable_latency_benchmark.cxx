@@ -0,0 +1,110 @@
+// this simulates a single-threaded event loop serving a stream of classification requests, mostly small graphs with the occasional huge one, and measures the latency of the small requests
+// it runs the stream twice: once classifying every request to completion in arrival order (as calling GSP_SP_OP would), and once interleaving the requests round-robin with gsp_sp_op_classifier, a bounded budget at a time
+// optional command line arguments: the order of the huge graphs (default 500000), and the budget per turn for the interleaved run (default 20000)
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct request {
+	graph g;
+	double arrival; // seconds after the start of the run
+	bool big;
+	bool is_gsp;	// the expected answer, to check the interleaved classifications against
+};
+
+std::vector<double> serve(std::vector<request> const& requests, long long budget, bool& ok) { // run the event loop over the requests (sorted by arrival), giving each active request budget units of work per turn, and return each request's latency
+	std::vector<double> latency(requests.size());
+	std::deque<std::pair<size_t, gsp_sp_op_classifier<graph>>> active;
+	size_t next = 0, finished = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	while (finished < requests.size()) {
+		double now = seconds_since(start);
+		for (; next < requests.size() && requests[next].arrival <= now; next++) active.emplace_back(next, gsp_sp_op_classifier{requests[next].g});
+
+		if (active.empty()) { // idle until the next request arrives
+			std::this_thread::sleep_for(std::chrono::duration<double>(requests[next].arrival - now));
+			continue;
+		}
+
+		std::pair<size_t, gsp_sp_op_classifier<graph>> turn = std::move(active.front());
+		active.pop_front();
+		if (turn.second.resume(budget)) {
+			latency[turn.first] = seconds_since(start) - requests[turn.first].arrival;
+			ok = ok && turn.second.result()->is_gsp == requests[turn.first].is_gsp;
+			finished++;
+		} else {
+			active.push_back(std::move(turn));
+		}
+	}
+
+	return latency;
+}
+
+void report(char const * name, std::vector<request> const& requests, std::vector<double> const& latency) {
+	std::vector<double> small, big;
+	for (size_t i = 0; i < requests.size(); i++) (requests[i].big ? big : small).push_back(latency[i]);
+	std::sort(small.begin(), small.end());
+	auto pct = [&](double p) {return small[std::min(small.size() - 1, (size_t)(p * (double)(small.size())))] * 1000;};
+
+	std::cout << name << "small requests: p50 " << pct(0.5) << "ms, p99 " << pct(0.99) << "ms, p99.9 " << pct(0.999) << "ms, max " << small.back() * 1000 << "ms; ";
+	std::cout << "huge requests: mean " << std::accumulate(big.begin(), big.end(), 0.0) / (double)(big.size()) * 1000 << "ms\n";
+}
+
+int main(int argc, char ** argv) {
+	int big_n = argc > 1 ? std::atoi(argv[1]) : 500000;
+	long long budget = argc > 2 ? std::atoll(argv[2]) : 20000;
+	std::mt19937 rng{2024};
+
+	// time one huge graph to size the stream, so the event loop is busy about half of the time in both runs
+	graph probe = random_gsp_graph(big_n, 0);
+	auto start = std::chrono::steady_clock::now();
+	GSP_SP_OP(probe);
+	double big_time = seconds_since(start);
+
+	int n_big = 4, n_small = 4000;
+	double window = 2 * n_big * big_time + 1;
+	std::vector<request> requests;
+	for (int i = 0; i < n_big; i++) requests.push_back({random_gsp_graph(big_n, (unsigned)(i + 1)), window * (2 * i + 1) / (2 * n_big), true, true});
+	for (int i = 0; i < n_small; i++) {
+		graph g = random_gsp_graph(50 + (int)(rng() % 450), (unsigned)(rng()));
+		if (i % 4 == 0) { // make some of them non-GSP, so they exit early the way a real mix would
+			int u = (int)(rng() % g.n), v = (int)(rng() % g.n);
+			if (u != v && !g.adjacent(u, v)) {
+				g.add_edge(u, v);
+				g.e++;
+			}
+		}
+		bool is_gsp = GSP_SP_OP(g).is_gsp;
+		requests.push_back({std::move(g), std::uniform_real_distribution<double>{0, window}(rng), false, is_gsp});
+	}
+	std::sort(requests.begin(), requests.end(), [](request const& a, request const& b) {return a.arrival < b.arrival;});
+
+	std::cout << n_small << " small requests (50 to 500 vertices) and " << n_big << " huge ones (" << big_n << " vertices, about " << std::fixed << std::setprecision(3) << big_time << "s each) over " << window << "s\n";
+
+	bool ok = true;
+	report("run to completion:       ", requests, serve(requests, LLONG_MAX, ok));
+	report("interleaved:             ", requests, serve(requests, budget, ok));
+
+	// cancelling a huge classification partway through
+	gsp_sp_op_classifier c{probe};
+	while (c.progress() < 0.5) c.resume(budget);
+	start = std::chrono::steady_clock::now();
+	c.cancel();
+	std::cout << "cancelled a huge classification at " << std::setprecision(0) << c.progress() * 100 << "% progress in " << std::setprecision(3) << seconds_since(start) * 1000 << "ms\n";
+
+	if (!ok) std::cout << "an interleaved classification disagreed with GSP_SP_OP\n";
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// this file contains a fixed-capacity graph type for graphs of at most a few words' worth of vertices, and the fixed-size buffers the implementation keeps its per-vertex state in while working on one
+// on tiny graphs the general implementation spends most of its time setting up and tearing down a dozen or so vectors and DFS stacks; with a small_graph all of those live in the coroutine frame instead
+
+#ifndef __SMALL_GRAPH_HXX__
+#define __SMALL_GRAPH_HXX__
+
+#include "graph.hxx"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename T, int capacity>
+struct inline_vector { // a vector of at most capacity elements stored inline, so it never allocates; it has just as much of std::vector's interface as the implementation uses for its per-vertex state and DFS stacks (through std::stack)
+	using value_type = T;
+	using size_type = size_t;
+	using reference = T&;
+	using const_reference = T const&;
+
+	std::array<T, capacity> items{};
+	int count = 0;
+
+	inline_vector() {}
+	explicit inline_vector(size_t n) : count{(int)(fit(n))} {} // n default elements (every element starts out default)
+	inline_vector(size_t n, T const& value) : count{(int)(fit(n))} {
+		for (int i = 0; i < count; i++) items[i] = value;
+	}
+
+	T& operator[](size_t i) {return items[i];}
+	T const& operator[](size_t i) const {return items[i];}
+	T& back() {return items[count - 1];}
+	T const& back() const {return items[count - 1];}
+	T * begin() {return items.data();}
+	T * end() {return items.data() + count;}
+	T const * begin() const {return items.data();}
+	T const * end() const {return items.data() + count;}
+	size_t size() const {return (size_t)(count);}
+	bool empty() const {return count == 0;}
+
+	void push_back(T const& value) { // going past capacity would write past the end of items (and, in a coroutine frame, over whatever follows it), so every build checks, and throws like a vector past its max_size
+		fit((size_t)(count) + 1);
+		items[count++] = value;
+	}
+	void push_back(T&& value) {
+		fit((size_t)(count) + 1);
+		items[count++] = std::move(value);
+	}
+	template <typename... Args>
+	T& emplace_back(Args&&... args) {
+		fit((size_t)(count) + 1);
+		items[count] = T{std::forward<Args>(args)...};
+		return items[count++];
+	}
+	void pop_back() { // reset the element so anything it owns is freed now, as it would be by a vector
+		assert(count > 0);
+		if constexpr (std::is_trivially_destructible_v<T>) {
+			count--;
+		} else {
+			items[--count] = T{};
+		}
+	}
+	void clear() {
+		if constexpr (std::is_trivially_destructible_v<T>) {
+			count = 0;
+		} else {
+			while (count > 0) pop_back();
+		}
+	}
+
+private:
+	static size_t fit(size_t n) { // n, if that many elements fit
+		if (n > (size_t)(capacity)) [[unlikely]] throw std::length_error{"inline_vector: more elements than its capacity"};
+		return n;
+	}
+};
+
+template <int N>
+struct small_graph { // a graph on at most N vertices with its adjacency lists stored inline (as bytes) and an adjacency bitset per vertex, so the whole graph is one block of memory and adjacent() is a single bit test
+					 // it presents the same interface as graph (see graph.hxx), and keeps the vertex numbers and adjacency list order of the graph it was built from, so the implementation produces exactly the same result on it
+	static_assert(N > 0 && N <= 256, "small_graph stores vertices as bytes");
+	static constexpr int words = (N + 63) / 64;
+
+	int n;
+	int e;
+	std::array<int, N> degrees;
+	std::array<std::array<unsigned char, N>, N> lists;		 // lists[v][i] is entry i of v's adjacency list (there is room for N entries per vertex, enough for any graph fits accepts)
+	std::array<std::array<uint64_t, words>, N> adjacency; // bit u of adjacency[v] is set if u and v are adjacent
+
+	static bool fits(graph const& g) { // whether g can be stored in a small_graph<N>, i.e. it has at most N vertices, none of which has more than N adjacency list entries
+		if (g.n > N) return false;
+		for (int v = 0; v < g.n; v++) {
+			if (g.adjLists[v].size() > (size_t)(N)) return false;
+		}
+		return true;
+	}
+
+	explicit small_graph(graph const& g) : n{g.n}, e{g.e} { // copy g, which must fit
+		for (int v = 0; v < n; v++) {
+			adjacency[v].fill(0);
+			degrees[v] = (int)(g.adjLists[v].size());
+			for (int i = 0; i < degrees[v]; i++) {
+				int u = g.adjLists[v][i];
+				lists[v][i] = (unsigned char)(u);
+				adjacency[v][u >> 6] |= uint64_t{1} << (u & 63);
+			}
+		}
+	}
+
+	int degree(int v) const {return degrees[v];}
+	int neighbor(int v, int i) const {return lists[v][i];}
+	std::span<unsigned char const> neighbors(int v) const {return {lists[v].data(), (size_t)(degrees[v])};}
+	bool adjacent(int e1, int e2) const {return (adjacency[e1][e2 >> 6] >> (e2 & 63)) & 1;}
+
+	void output_adj_list(int v, std::ostream& os) const {
+		os << "vertex " << v << " adjacencies: ";
+
+		for (int v2 : neighbors(v)) {
+			os << v2 << " ";
+		}
+
+		os << "\n";
+	}
+};
+
+template <int N>
+std::ostream& operator<<(std::ostream& os, small_graph<N> const& g) { // output a small graph (for debugging purposes)
+	os << "Small graph with " << g.n << " vertices and " << g.e << " edges:\n";
+
+	for (int i = 0; i < g.n; i++) {
+		g.output_adj_list(i, os);
+	}
+
+	return os;
+}
+
+template <int N>
+struct graph_storage<small_graph<N>> { // the implementation never needs more than N + 1 entries in any per-vertex array or DFS stack (the extra one is for the infinity entry of dfs_no)
+	template <typename T>
+	using vertex_array = inline_vector<T, N + 1>;
+};
+
+#endif
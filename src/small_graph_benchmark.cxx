@@ -0,0 +1,68 @@
+// this measures graphs per second on the small configurations of random_tester.cxx, classifying each graph both through the general implementation (gsp_sp_op_direct on the graph itself) and through GSP_SP_OP, which copies graphs of at most 128 vertices into a small_graph first
+// the two must give byte-for-byte identical certificates (compared through their serialized form), so the small_graph path is checked against the general one on every graph
+// it then does the same for classifying and authenticating, each result authenticated against the caller's graph
+// optional command line argument: the number of graphs of each size class (default 20000)
+
+#include "gsp-sp-op.hxx"
+#include "gsp-sp-op-serialization.hxx"
+#include "GraphGenerator.hxx"
+#include "benchmark-util.hxx"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template <typename Classify>
+double graphs_per_second(std::vector<graph> const& graphs, Classify classify) { // the best of a few passes over all the graphs
+	double best = 0;
+	for (int pass = 0; pass < 3; pass++) {
+		auto start = std::chrono::steady_clock::now();
+		for (graph const& g : graphs) classify(g);
+		best = std::max(best, (double)(graphs.size()) / seconds_since(start));
+	}
+	return best;
+}
+
+int main(int argc, char ** argv) {
+	int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+	std::mt19937 rng{4540};
+	bool failed = false;
+
+	// the parameter ranges of random_tester.cxx, except for the number of cycles, which is kept small enough that most graphs have at most 128 vertices
+	std::uniform_int_distribution<long> nC{2, 20}, lC{3, 10}, nK{0, 1}, lK{4, 10}, three_edges{0, 1};
+	std::vector<graph> classes[3]; // up to 64 vertices, 65 to 128 vertices, and more (which both paths classify the same way, as a control)
+	while (classes[0].size() < (size_t)(count) || classes[1].size() < (size_t)(count) || classes[2].size() < (size_t)(count)) {
+		graph g = generate_graph(nC(rng), lC(rng), nK(rng), lK(rng), three_edges(rng), (long)(rng()));
+		int c = g.n <= 64 ? 0 : g.n <= 128 ? 1 : 2;
+		if (classes[c].size() < (size_t)(count)) classes[c].push_back(std::move(g));
+	}
+
+	char const * names[3] = {"n <= 64:       ", "64 < n <= 128: ", "n > 128:       "};
+	std::cout << std::fixed << std::setprecision(0);
+	for (int c = 0; c < 3; c++) {
+		long long vertices = 0;
+		int mismatches = 0;
+		for (graph const& g : classes[c]) {
+			vertices += g.n;
+			std::vector<unsigned char> general, dispatched;
+			bool ok_general = serialize_result(gsp_sp_op_direct(g), general);
+			bool ok_dispatched = serialize_result(GSP_SP_OP(g), dispatched);
+			if (ok_general != ok_dispatched || general != dispatched) mismatches++;
+			if (gsp_sp_op_direct(g).authenticate(g) != GSP_SP_OP(g).authenticate(g)) mismatches++;
+		}
+
+		double general = graphs_per_second(classes[c], [](graph const& g) {return gsp_sp_op_direct(g).is_gsp;});
+		double dispatched = graphs_per_second(classes[c], [](graph const& g) {return GSP_SP_OP(g).is_gsp;});
+		std::cout << names[c] << count << " graphs (" << std::setw(3) << vertices / count << " vertices on average): general " << std::setw(7) << general << " graphs/s, GSP_SP_OP " << std::setw(7) << dispatched << " graphs/s ("
+				  << std::setprecision(2) << dispatched / general << "x)" << std::setprecision(0) << (mismatches ? ", " : "") << (mismatches ? std::to_string(mismatches) + " with different certificates" : "") << "\n";
+
+		general = graphs_per_second(classes[c], [](graph const& g) {return gsp_sp_op_direct(g).authenticate(g);});
+		dispatched = graphs_per_second(classes[c], [](graph const& g) {return GSP_SP_OP(g).authenticate(g);});
+		std::cout << "  and authenticating:                               general " << std::setw(7) << general << " graphs/s, GSP_SP_OP " << std::setw(7) << dispatched << " graphs/s (" << std::setprecision(2) << dispatched / general << "x)\n" << std::setprecision(0);
+		failed = failed || mismatches;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,383 @@
+// this file contains a bottom-up dynamic programming framework over SP decomposition trees, and solvers built on it for problems that are hard in general but linear time on GSP graphs
+// a DP is a policy type with a table type and one function per kind of node in the tree:
+//   table edge(int source, int sink)
+//   table series(table const& l, table const& r, int mid)         l is (source, mid) and r is (mid, sink); mid is eliminated here, it has no edges outside this subgraph
+//   table parallel(table const& l, table const& r)                 both children are (source, sink)
+//   table antiparallel(table const& l, table const& r)             l is (source, sink) and r is (sink, source)
+//   table dangling(table const& l, table const& r, int tip)        l is (source, sink) and r is (source, tip); tip is eliminated here
+// the tables are always oriented the way the decomposition tree stores its sources and sinks (which is also how the authentication in the certificates checks them), so an antiparallel node is just a parallel node with the right child's table transposed
+// every vertex other than the root's source and sink is eliminated at exactly one node, so solvers fold in a vertex's own contribution when it is eliminated and the root's terminals at the end
+// the policy is a template parameter so every combine step is inlined; a DP over a tree with m nodes makes m calls and keeps at most one table per level of the tree alive
+// DPs run over the flat post-order layout, which a certificate already holds its tree in, so any number of DPs can run over it without building anything
+
+#ifndef __SP_DP_HXX__
+#define __SP_DP_HXX__
+
+#include "graph.hxx"
+#include "sp-tree.hxx"
+#include "gsp-sp-op-certificates.hxx"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+flat_sp_tree const * gsp_decomposition(gsp_sp_op_result const& r) { // the decomposition tree proving a graph is GSP, or nullptr if it isn't
+	if (!r.is_gsp) return nullptr;
+	positive_cert_gsp const * cert = dynamic_cast<positive_cert_gsp const *>(r.gsp_reason.get());
+	return cert ? &cert->decomposition : nullptr;
+}
+
+template <typename Policy>
+typename Policy::table sp_dp_combine(Policy const& p, flat_sp_tree const& t, int i, typename Policy::table const& l, typename Policy::table const& r) { // combine the tables of composed node i's children
+	switch (t.nodes[i].comp) {
+		case c_type::series:
+			return p.series(l, r, t.nodes[t.left(i)].sink);
+		case c_type::parallel:
+			return p.parallel(l, r);
+		case c_type::antiparallel:
+			return p.antiparallel(l, r);
+		case c_type::dangling:
+			return p.dangling(l, r, t.nodes[t.right(i)].sink);
+		case c_type::edge:
+			break;
+	}
+	return p.edge(t.nodes[i].source, t.nodes[i].sink);
+}
+
+template <typename Policy>
+typename Policy::table sp_dp(flat_sp_tree const& t, Policy const& p) { // run a DP over a (non-empty) decomposition tree and return the root's table
+																	   // one forward scan; only the tables of finished subtrees waiting for their sibling are kept (at most one per level of the tree)
+	std::vector<typename Policy::table> done;
+	for (int i = 0; i <= t.root(); i++) {
+		if (t.nodes[i].comp == c_type::edge) {
+			done.push_back(p.edge(t.nodes[i].source, t.nodes[i].sink));
+		} else {
+			typename Policy::table r = std::move(done.back());
+			done.pop_back();
+			done.back() = sp_dp_combine(p, t, i, done.back(), r);
+		}
+	}
+
+	return std::move(done.back());
+}
+
+template <typename Policy>
+std::vector<typename Policy::table> sp_dp_all(flat_sp_tree const& t, Policy const& p) { // run a DP over a (non-empty) decomposition tree, keeping every node's table (indexed like t.nodes) so solutions can be reconstructed top-down
+	std::vector<typename Policy::table> tables;
+	tables.reserve(t.nodes.size());
+	for (int i = 0; i <= t.root(); i++) {
+		if (t.nodes[i].comp == c_type::edge) {
+			tables.push_back(p.edge(t.nodes[i].source, t.nodes[i].sink));
+		} else {
+			tables.push_back(sp_dp_combine(p, t, i, tables[t.left(i)], tables[t.right(i)]));
+		}
+	}
+
+	return tables;
+}
+
+// ---------------- vertex state DPs ----------------
+// most problems on GSP graphs only care about a finite state per vertex (in the set or not, which colour, ...), and combine values over a semiring (max-plus for weight optimization, plus-times for counting, ...)
+// a vertex state problem describes that, and vertex_state_dp turns it into a policy whose tables are indexed [source state][sink state]:
+//   static constexpr int states          number of states per vertex
+//   using value = ...;                   semiring element
+//   value zero() const, value one() const, value plus(value, value) const, value times(value, value) const
+//   value vertex(int v, int state) const              contribution of a vertex being in a state
+//   value edge(int u, int v, int su, int sv) const    contribution of an edge whose ends are in the given states (zero() if they can't be)
+
+template <typename Problem>
+struct vertex_state_dp {
+	static constexpr int K = Problem::states;
+	using value = typename Problem::value;
+	using table = std::array<std::array<value, K>, K>;
+
+	Problem const& prob;
+
+	table edge(int source, int sink) const {
+		table t;
+		for (int a = 0; a < K; a++) {
+			for (int b = 0; b < K; b++) t[a][b] = prob.edge(source, sink, a, b);
+		}
+		return t;
+	}
+
+	table series(table const& l, table const& r, int mid) const {
+		table t;
+		for (int a = 0; a < K; a++) {
+			for (int b = 0; b < K; b++) {
+				value sum = prob.zero();
+				for (int m = 0; m < K; m++) sum = prob.plus(sum, prob.times(prob.times(l[a][m], r[m][b]), prob.vertex(mid, m)));
+				t[a][b] = sum;
+			}
+		}
+		return t;
+	}
+
+	table parallel(table const& l, table const& r) const {
+		table t;
+		for (int a = 0; a < K; a++) {
+			for (int b = 0; b < K; b++) t[a][b] = prob.times(l[a][b], r[a][b]);
+		}
+		return t;
+	}
+
+	table antiparallel(table const& l, table const& r) const {
+		table t;
+		for (int a = 0; a < K; a++) {
+			for (int b = 0; b < K; b++) t[a][b] = prob.times(l[a][b], r[b][a]);
+		}
+		return t;
+	}
+
+	table dangling(table const& l, table const& r, int tip) const {
+		table t;
+		for (int a = 0; a < K; a++) {
+			value hanging = prob.zero(); // everything the dangling subgraph can contribute with its source in state a
+			for (int x = 0; x < K; x++) hanging = prob.plus(hanging, prob.times(r[a][x], prob.vertex(tip, x)));
+			for (int b = 0; b < K; b++) t[a][b] = prob.times(l[a][b], hanging);
+		}
+		return t;
+	}
+
+	value finish(table const& t, int source, int sink) const { // fold in the root's terminals
+		value sum = prob.zero();
+		for (int a = 0; a < K; a++) {
+			for (int b = 0; b < K; b++) sum = prob.plus(sum, prob.times(prob.times(t[a][b], prob.vertex(source, a)), prob.vertex(sink, b)));
+		}
+		return sum;
+	}
+};
+
+template <typename Problem>
+typename Problem::value solve_vertex_state(flat_sp_tree const& t, int n, Problem const& prob) { // the semiring sum over every assignment of states to the n vertices of the graph t decomposes
+	vertex_state_dp<Problem> dp{prob};
+	if (t.empty()) { // no edges, so every vertex is on its own (only a graph with at most one vertex has an empty decomposition)
+		typename Problem::value product = prob.one();
+		for (int v = 0; v < n; v++) {
+			typename Problem::value sum = prob.zero();
+			for (int x = 0; x < Problem::states; x++) sum = prob.plus(sum, prob.vertex(v, x));
+			product = prob.times(product, sum);
+		}
+		return product;
+	}
+
+	return dp.finish(sp_dp(t, dp), t.nodes.back().source, t.nodes.back().sink);
+}
+
+template <typename Problem>
+std::vector<int> optimal_vertex_states(flat_sp_tree const& t, int n, Problem const& prob) { // an assignment of states to the n vertices achieving solve_vertex_state, for semirings where plus picks one of its arguments (max, min, or)
+																							// returns an empty vector if no assignment has a nonzero value
+	using value = typename Problem::value;
+	constexpr int K = Problem::states;
+	std::vector<int> state((size_t)(n), -1);
+
+	auto best_state = [&](int v) { // best state of a vertex with no edges
+		value best = prob.zero();
+		for (int x = 0; x < K; x++) best = prob.plus(best, prob.vertex(v, x));
+		for (int x = 0; x < K; x++) {
+			if (prob.vertex(v, x) == best) return x;
+		}
+		return 0;
+	};
+
+	if (t.empty()) {
+		for (int v = 0; v < n; v++) state[v] = best_state(v);
+		return state;
+	}
+
+	vertex_state_dp<Problem> dp{prob};
+	std::vector<typename vertex_state_dp<Problem>::table> tables = sp_dp_all(t, dp);
+	int root = t.root();
+	int src = t.nodes[root].source, snk = t.nodes[root].sink;
+
+	value best = dp.finish(tables[root], src, snk);
+	if (best == prob.zero()) return {};
+
+	std::vector<std::pair<char, char>> chosen(t.nodes.size()); // (source state, sink state) picked for each node; parents come after their children, so a backward scan fills these in top-down
+	for (int a = 0; a < K; a++) {
+		for (int b = 0; b < K; b++) {
+			if (prob.times(prob.times(tables[root][a][b], prob.vertex(src, a)), prob.vertex(snk, b)) == best) {
+				chosen[root] = {(char)(a), (char)(b)};
+				a = K;
+				break;
+			}
+		}
+	}
+
+	for (int i = root; i >= 0; i--) {
+		flat_sp_node const& node = t.nodes[i];
+		int a = chosen[i].first, b = chosen[i].second;
+		state[node.source] = a;
+		state[node.sink] = b;
+		if (node.comp == c_type::edge) continue;
+
+		int li = t.left(i), ri = t.right(i);
+		auto const& l = tables[li];
+		auto const& r = tables[ri];
+
+		switch (node.comp) {
+			case c_type::series: {
+				int mid = t.nodes[li].sink;
+				for (int m = 0; m < K; m++) {
+					if (prob.times(prob.times(l[a][m], r[m][b]), prob.vertex(mid, m)) == tables[i][a][b]) {
+						chosen[li] = {(char)(a), (char)(m)};
+						chosen[ri] = {(char)(m), (char)(b)};
+						break;
+					}
+				}
+				break;
+			}
+			case c_type::parallel:
+				chosen[li] = chosen[ri] = {(char)(a), (char)(b)};
+				break;
+			case c_type::antiparallel:
+				chosen[li] = {(char)(a), (char)(b)};
+				chosen[ri] = {(char)(b), (char)(a)};
+				break;
+			case c_type::dangling: {
+				int tip = t.nodes[ri].sink;
+				value hanging = prob.zero();
+				for (int x = 0; x < K; x++) hanging = prob.plus(hanging, prob.times(r[a][x], prob.vertex(tip, x)));
+				chosen[li] = {(char)(a), (char)(b)};
+				for (int x = 0; x < K; x++) {
+					if (prob.times(r[a][x], prob.vertex(tip, x)) == hanging) {
+						chosen[ri] = {(char)(a), (char)(x)};
+						break;
+					}
+				}
+				break;
+			}
+			case c_type::edge:
+				break;
+		}
+	}
+
+	for (int v = 0; v < n; v++) { // anything the decomposition doesn't touch has no edges
+		if (state[v] == -1) state[v] = best_state(v);
+	}
+
+	return state;
+}
+
+// ---------------- built-in solvers ----------------
+
+struct sp_vertex_set {
+	long long weight;
+	std::vector<int> vertices;
+};
+
+struct max_plus_weights { // shared by independent set and vertex cover, which differ only in which way they optimize and which edges are allowed
+	static constexpr int states = 2; // 0 = not in the set, 1 = in the set
+	using value = long long;
+	static constexpr value inf = std::numeric_limits<long long>::max() / 4; // weights are assumed to sum to less than this in absolute value
+
+	std::vector<long long> const& weights;
+	bool maximize;
+
+	value zero() const { return maximize ? -inf : inf; }
+	value one() const { return 0; }
+	value plus(value a, value b) const { return maximize ? std::max(a, b) : std::min(a, b); }
+	value times(value a, value b) const { return maximize ? std::max(a + b, -inf) : std::min(a + b, inf); } // saturate, so zero() stays absorbing
+	value vertex(int v, int state) const { return state ? weights[v] : 0; }
+};
+
+struct mwis_problem : max_plus_weights {
+	value edge(int, int, int a, int b) const { return (a && b) ? zero() : one(); }
+};
+
+struct mvc_problem : max_plus_weights {
+	value edge(int, int, int a, int b) const { return (a || b) ? one() : zero(); }
+};
+
+sp_vertex_set sp_states_to_set(std::vector<int> const& state, std::vector<long long> const& weights) {
+	sp_vertex_set s{0, {}};
+	for (size_t v = 0; v < state.size(); v++) {
+		if (state[v] == 1) {
+			s.vertices.push_back((int)(v));
+			s.weight += weights[v];
+		}
+	}
+	return s;
+}
+
+sp_vertex_set sp_max_weight_independent_set(flat_sp_tree const& t, std::vector<long long> const& weights) { // maximum weight independent set of the graph t decomposes, which has weights.size() vertices
+	mwis_problem prob{{weights, true}};
+	return sp_states_to_set(optimal_vertex_states(t, (int)(weights.size()), prob), weights);
+}
+
+sp_vertex_set sp_min_weight_vertex_cover(flat_sp_tree const& t, std::vector<long long> const& weights) { // minimum weight vertex cover of the graph t decomposes, which has weights.size() vertices
+	mvc_problem prob{{weights, false}};
+	return sp_states_to_set(optimal_vertex_states(t, (int)(weights.size()), prob), weights);
+}
+
+struct three_colorable_problem { // boolean semiring, used to find a colouring
+	static constexpr int states = 3;
+	using value = bool;
+
+	value zero() const { return false; }
+	value one() const { return true; }
+	value plus(value a, value b) const { return a || b; }
+	value times(value a, value b) const { return a && b; }
+	value vertex(int, int) const { return true; }
+	value edge(int, int, int a, int b) const { return a != b; }
+};
+
+struct three_coloring_count_problem { // counting semiring modulo some modulus less than 2^32
+	static constexpr int states = 3;
+	using value = uint64_t;
+
+	uint64_t modulus;
+
+	value zero() const { return 0; }
+	value one() const { return 1 % modulus; }
+	value plus(value a, value b) const { return (a + b) % modulus; }
+	value times(value a, value b) const { return a * b % modulus; }
+	value vertex(int, int) const { return one(); }
+	value edge(int, int, int a, int b) const { return a != b ? one() : zero(); }
+};
+
+std::vector<int> sp_three_coloring(flat_sp_tree const& t, int n) { // a proper colouring of the graph t decomposes with colours 0, 1, 2 (every GSP graph has one, since they're all 2-degenerate)
+	return optimal_vertex_states(t, n, three_colorable_problem{});
+}
+
+uint64_t sp_count_three_colorings(flat_sp_tree const& t, int n, uint64_t modulus = 1000000007) { // number of proper 3-colourings of the graph t decomposes, modulo modulus (which must be less than 2^32)
+	return solve_vertex_state(t, n, three_coloring_count_problem{modulus});
+}
+
+// ---------------- spanning trees ----------------
+// this one isn't a vertex state problem: what matters is how a subgraph's spanning forest connects its terminals
+// the table is (connected, split): the number of spanning trees of the subgraph, and the number of spanning forests with exactly two trees, one containing each terminal
+
+struct spanning_tree_dp {
+	struct table {
+		uint64_t connected;
+		uint64_t split;
+	};
+
+	uint64_t modulus;
+
+	table edge(int, int) const { return {1 % modulus, 1 % modulus}; } // take the edge, or leave it out and have the terminals apart
+
+	table series(table const& l, table const& r, int) const { // the middle vertex has to end up connected to at least one side
+		return {l.connected * r.connected % modulus, (l.connected * r.split + l.split * r.connected) % modulus};
+	}
+
+	table parallel(table const& l, table const& r) const { // at most one side can connect the terminals, or there'd be a cycle
+		return {(l.connected * r.split + l.split * r.connected) % modulus, l.split * r.split % modulus};
+	}
+
+	table antiparallel(table const& l, table const& r) const { return parallel(l, r); } // symmetric in source and sink
+
+	table dangling(table const& l, table const& r, int) const { // the tip can only reach the rest of the graph through the source, so the dangling subgraph has to be connected
+		return {l.connected * r.connected % modulus, l.split * r.connected % modulus};
+	}
+};
+
+uint64_t sp_count_spanning_trees(flat_sp_tree const& t, int n, uint64_t modulus = 1000000007) { // number of spanning trees of the graph t decomposes, modulo modulus (which must be less than 2^32)
+	if (t.empty()) return n <= 1 ? 1 % modulus : 0;
+	return sp_dp(t, spanning_tree_dp{modulus}).connected;
+}
+
+#endif
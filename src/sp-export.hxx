@@ -0,0 +1,315 @@
+// this file contains streaming exporters for graphs and decomposition trees, which write DOT, GraphML or a compact JSON form (Cytoscape's elements format) straight to a stream in a single pass
+// nothing is built up in memory first: every node and edge is written as soon as it's reached, so an export takes linear time and constant memory on top of the graph or flat tree itself
+// decomposition trees of big graphs are far too large to render, so there is also a summarizing mode, which merges every maximal run of compositions of the same type into one node and collapses small subtrees into counts, drawing at most a fixed number of nodes
+
+#ifndef __SP_EXPORT_HXX__
+#define __SP_EXPORT_HXX__
+
+#include "graph.hxx"
+#include "sp-tree.hxx"
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+enum class export_format {
+	dot, json, graphml
+};
+
+enum class export_kind { // what an exported node stands for, which decides how it's drawn
+	vertex, edge, series, parallel, dangling, collapsed
+};
+
+char const * export_kind_name(export_kind kind) {
+	switch (kind) {
+		case export_kind::vertex:
+			return "vertex";
+		case export_kind::edge:
+			return "edge";
+		case export_kind::series:
+			return "series";
+		case export_kind::parallel:
+			return "parallel";
+		case export_kind::dangling:
+			return "dangling";
+		case export_kind::collapsed:
+			break;
+	}
+	return "collapsed";
+}
+
+export_kind export_kind_of(c_type comp) { // antiparallel compositions are drawn (and merged) like parallel ones
+	switch (comp) {
+		case c_type::edge:
+			return export_kind::edge;
+		case c_type::series:
+			return export_kind::series;
+		case c_type::parallel:
+		case c_type::antiparallel:
+			return export_kind::parallel;
+		case c_type::dangling:
+			break;
+	}
+	return export_kind::dangling;
+}
+
+struct export_writer { // writes nodes and edges to a stream one at a time in one of the formats; node ids are a one-letter prefix and a number, so nothing needs to be looked up or remembered
+					   // the edges of a node may be written before the node itself, which all three formats allow
+					   // output goes through a fixed-size buffer, formatted with std::to_chars, since formatting every number through the stream is what made exports slower than classification
+	std::ostream& os;
+	export_format format;
+	bool directed = false;
+	bool first = true; // (JSON) no element has been written yet, so the next one needs no comma in front of it
+	std::string buffer;
+
+	static constexpr size_t buffer_size = 1 << 16;
+
+	export_writer(std::ostream& os_, export_format format_) : os{os_}, format{format_} {buffer.reserve(buffer_size + 256);}
+	~export_writer() {flush();}
+
+	void flush() {
+		os.write(buffer.data(), (std::streamsize)(buffer.size()));
+		buffer.clear();
+	}
+
+	void put(std::string_view text) {
+		buffer += text;
+		if (buffer.size() >= buffer_size) flush();
+	}
+
+	void put(long long number) {
+		char digits[24];
+		buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+	}
+
+	void put_id(char prefix, long long id) {
+		buffer += prefix;
+		put(id);
+	}
+
+	void begin(char const * name, bool directed_) { // everything before the first node or edge
+		directed = directed_;
+		first = true;
+		if (format == export_format::dot) {
+			put(directed ? "digraph " : "graph ");
+			put(name);
+			put(" {\n  node [fontsize=10, style=filled];\n");
+			if (directed) put("  ordering=out;\n"); // keep children left to right
+		} else if (format == export_format::json) {
+			put("{\"name\":\"");
+			put(name);
+			put(directed ? "\",\"directed\":true,\"elements\":[\n" : "\",\"directed\":false,\"elements\":[\n");
+		} else {
+			put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+				"  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n  <key id=\"kind\" for=\"node\" attr.name=\"kind\" attr.type=\"string\"/>\n  <graph id=\"");
+			put(name);
+			put(directed ? "\" edgedefault=\"directed\">\n" : "\" edgedefault=\"undirected\">\n");
+		}
+	}
+
+	void end() {
+		if (format == export_format::dot) {
+			put("}\n");
+		} else if (format == export_format::json) {
+			put("\n]}\n");
+		} else {
+			put("  </graph>\n</graphml>\n");
+		}
+		flush();
+	}
+
+	void label(std::string_view text) { // a label with line breaks ('\n') and anything special escaped for the format
+		for (char c : text) {
+			if (c == '\n') {
+				buffer += (format == export_format::graphml ? "&#10;" : "\\n");
+			} else if (format == export_format::graphml && (c == '<' || c == '>' || c == '&' || c == '"')) {
+				buffer += (c == '<' ? "&lt;" : c == '>' ? "&gt;" : c == '&' ? "&amp;" : "&quot;");
+			} else {
+				if (format != export_format::graphml && (c == '"' || c == '\\')) buffer += '\\';
+				buffer += c;
+			}
+		}
+	}
+
+	void node(char prefix, long long id, std::string_view text, export_kind kind) {
+		if (format == export_format::dot) {
+			put("  ");
+			put_id(prefix, id);
+			put(" [label=\"");
+			label(text);
+			switch (kind) {
+				case export_kind::vertex:
+					put("\", shape=circle, fillcolor=white];\n");
+					break;
+				case export_kind::edge:
+					put("\", shape=box, fillcolor=white];\n");
+					break;
+				case export_kind::series:
+					put("\", shape=ellipse, fillcolor=lightblue];\n");
+					break;
+				case export_kind::parallel:
+					put("\", shape=ellipse, fillcolor=lightgreen];\n");
+					break;
+				case export_kind::dangling:
+					put("\", shape=ellipse, fillcolor=orange];\n");
+					break;
+				case export_kind::collapsed:
+					put("\", shape=plaintext, fillcolor=white];\n");
+					break;
+			}
+		} else if (format == export_format::json) {
+			put(first ? "{\"data\":{\"id\":\"" : ",\n{\"data\":{\"id\":\"");
+			put_id(prefix, id);
+			put("\",\"label\":\"");
+			label(text);
+			put("\",\"kind\":\"");
+			put(export_kind_name(kind));
+			put("\"}}");
+			first = false;
+		} else {
+			put("    <node id=\"");
+			put_id(prefix, id);
+			put("\"><data key=\"label\">");
+			label(text);
+			put("</data><data key=\"kind\">");
+			put(export_kind_name(kind));
+			put("</data></node>\n");
+		}
+	}
+
+	void edge(char prefix_a, long long a, char prefix_b, long long b) {
+		if (format == export_format::dot) {
+			put("  ");
+			put_id(prefix_a, a);
+			put(directed ? " -> " : " -- ");
+			put_id(prefix_b, b);
+			put(";\n");
+		} else if (format == export_format::json) {
+			put(first ? "{\"data\":{\"source\":\"" : ",\n{\"data\":{\"source\":\"");
+			put_id(prefix_a, a);
+			put("\",\"target\":\"");
+			put_id(prefix_b, b);
+			put("\"}}");
+			first = false;
+		} else {
+			put("    <edge source=\"");
+			put_id(prefix_a, a);
+			put("\" target=\"");
+			put_id(prefix_b, b);
+			put("\"/>\n");
+		}
+	}
+};
+
+template <typename Graph>
+void export_graph(Graph const& g, export_writer& w) { // write every vertex of G (as v<number>) and every edge, each as soon as it's reached
+	char digits[24];
+	for (int u = 0; u < g.n; u++) {
+		w.node('v', u, std::string_view{digits, (size_t)(std::to_chars(digits, digits + sizeof(digits), u).ptr - digits)}, export_kind::vertex);
+		for (int v : g.neighbors(u)) {
+			if (u < v) w.edge('v', u, 'v', v);
+		}
+	}
+}
+
+template <typename Graph>
+void export_graph(Graph const& g, std::ostream& os, export_format format) { // write G as a whole file
+	export_writer w{os, format};
+	w.begin("G", false);
+	export_graph(g, w);
+	w.end();
+}
+
+struct sp_export_config {
+	bool summarize = false;
+	int max_nodes = 1000;	// (summarizing) at most this many composition nodes are drawn; any subtree past that is collapsed into a count on its parent
+	int min_edges = 0;		// (summarizing) subtrees with fewer edges than this are collapsed into a count on their parent too; 0 means the tree's edges / max_nodes, so the budget goes to the big subtrees
+};
+
+void sp_export_label(flat_sp_node const& node, std::string& out) { // "source - sink" for an edge, and the composition type over "(source, sink)" otherwise
+	char digits[24];
+	out.clear();
+	if (node.comp != c_type::edge) {
+		out += c_type_char(node.comp);
+		out += "\n(";
+	}
+	out.append(digits, std::to_chars(digits, digits + sizeof(digits), node.source).ptr);
+	out += (node.comp == c_type::edge ? " - " : ", ");
+	out.append(digits, std::to_chars(digits, digits + sizeof(digits), node.sink).ptr);
+	if (node.comp != c_type::edge) out += ")";
+}
+
+void export_sp_tree_summary(flat_sp_tree const& t, export_writer& w, sp_export_config const& config) { // the summarizing mode of export_sp_tree
+																								   // the drawn compositions are visited breadth first from the root, so the budget goes to the top of the tree; each one's run of same-type compositions is walked with a backward scan over its subtree that jumps over every subtree it doesn't enter, so every tree node is looked at once at most
+	long long min_edges = config.min_edges > 0 ? config.min_edges : std::max(1, t.subtree_edges(t.root()) / std::max(config.max_nodes, 1));
+	std::deque<int> pending{t.root()}; // drawn compositions whose node hasn't been written yet (never more than max_nodes)
+	long long drawn = 1;
+	std::string label;
+
+	while (!pending.empty()) {
+		int g = pending.front();
+		pending.pop_front();
+		export_kind kind = export_kind_of(t.nodes[g].comp);
+		long long parts = 0, collapsed_parts = 0, collapsed_edges = 0;
+
+		for (int j = g, first = t.subtree_begin(g); j >= first;) {
+			flat_sp_node const& node = t.nodes[j];
+			if (j == g || (node.comp != c_type::edge && export_kind_of(node.comp) == kind)) { // part of the run, so go on into its right child (and its left child after that)
+				j--;
+				continue;
+			}
+
+			parts++; // a child of the run
+			if (node.comp != c_type::edge && t.subtree_edges(j) >= min_edges && drawn < config.max_nodes) {
+				drawn++;
+				pending.push_back(j);
+				w.edge('n', g, 'n', j);
+			} else {
+				collapsed_parts++;
+				collapsed_edges += t.subtree_edges(j);
+			}
+			j -= node.size;
+		}
+
+		sp_export_label(t.nodes[g], label);
+		label += "\n" + std::to_string(t.subtree_edges(g)) + " edges in " + std::to_string(parts) + " parts";
+		w.node('n', g, label, kind);
+		if (collapsed_parts > 0 && collapsed_parts < parts) { // if every part was collapsed the label already says it all
+			label = std::to_string(collapsed_parts) + (collapsed_parts == 1 ? " more part\n" : " more parts\n") + std::to_string(collapsed_edges) + (collapsed_edges == 1 ? " edge" : " edges");
+			w.node('c', g, label, export_kind::collapsed);
+			w.edge('n', g, 'c', g);
+		}
+	}
+}
+
+void export_sp_tree(flat_sp_tree const& t, export_writer& w, sp_export_config const& config = sp_export_config{}) { // write a (consistent) decomposition tree, with node i as n<i> and edges from parents to children, so the root is n<t.root()>
+																													// the full tree is written in post-order, each node followed by the edges to its children; the summary is described above
+	if (t.empty()) return;
+
+	if (config.summarize && t.nodes[t.root()].comp != c_type::edge) {
+		export_sp_tree_summary(t, w, config);
+		return;
+	}
+
+	std::string label;
+	for (int i = 0; i <= t.root(); i++) {
+		flat_sp_node const& node = t.nodes[i];
+		sp_export_label(node, label);
+		w.node('n', i, label, export_kind_of(node.comp));
+		if (node.comp != c_type::edge) {
+			w.edge('n', i, 'n', t.left(i));
+			w.edge('n', i, 'n', t.right(i));
+		}
+	}
+}
+
+void export_sp_tree(flat_sp_tree const& t, std::ostream& os, export_format format, sp_export_config const& config = sp_export_config{}) { // write a decomposition tree as a whole file
+	export_writer w{os, format};
+	w.begin("SP", true);
+	export_sp_tree(t, w, config);
+	w.end();
+}
+
+#endif
@@ -1,4 +1,4 @@
-// this file contains the definition of an SP tree, a SP chain stack entry, and associated operations on SP trees
+// this file contains the definition of an SP tree, its flattened post-order form, a SP chain stack entry, and associated operations on SP trees
 
 #ifndef __SP_TREE_HXX__
 #define __SP_TREE_HXX__
@@ -6,6 +6,8 @@
 #include "logging.hxx"
 #include <ostream>
 #include <stack>
+#include <utility>
+#include <vector>
 
 enum class c_type { // composition type
 	edge, series, parallel, antiparallel, dangling // an antiparallel composition is the exact same as a parallel composition, but the right node is flipped around
@@ -35,7 +37,7 @@ struct sp_tree_node { // a single node in the sp tree
 	sp_tree_node * r;
 	c_type comp;			// the type of composition this node represents, or c_type::edge if it's not a composition but a single edge
 
-	sp_tree_node(int source_, int sink_) : source{source_}, sink{sink_}, comp{c_type::edge} {} // construct edge node
+	sp_tree_node(int source_, int sink_) : source{source_}, sink{sink_}, l{nullptr}, r{nullptr}, comp{c_type::edge} {} // construct edge node (leaves need null children, the traversals use them to detect edges)
 
 	sp_tree_node(sp_tree_node * l_, sp_tree_node * r_, c_type comp_) : l{l_}, r{r_}, comp{comp_} {  // construct composed node
 		switch (comp) {
@@ -188,8 +190,12 @@ std::ostream& operator<<(std::ostream& os, sp_tree const& t) { // output an SP t
 
 sp_tree::~sp_tree() {
 	if (!root) return;
+	if (!root->l && !root->r) { // a single edge, which is what most of the trees freed while the implementation runs are, needs no traversal
+		delete root;
+		return;
+	}
 
-	std::stack<std::pair<sp_tree_node *, int>> hist;
+	std::stack<std::pair<sp_tree_node *, int>, std::vector<std::pair<sp_tree_node *, int>>> hist; // vector-backed, like sp_chain_stack, since a deque allocates even when it's empty
 	hist.emplace(root, 0);
 
 	while (!hist.empty()) {
@@ -206,6 +212,95 @@ sp_tree::~sp_tree() {
 	}
 }
 
+struct flat_sp_node { // a node of a flat_sp_tree
+	int source;
+	int sink;
+	int size;	 // number of nodes in the subtree rooted here (including this one), so the subtree is the size nodes ending at this one
+	c_type comp;
+};
+
+struct flat_sp_tree { // a finished SP decomposition tree frozen into one contiguous post-order array
+					  // since every node is the last entry of its own subtree, node i's right child is at i - 1 and its left child is at i - 1 - nodes[i - 1].size, so traversals are linear scans with no stack
+					  // scanning forwards visits children before parents (for bottom-up work), and scanning backwards visits parents before children (for top-down work)
+	std::vector<flat_sp_node> nodes;
+	bool well_formed = true; // false if the tree this was frozen from had a node with one child, a non-edge leaf, or an edge with children
+
+	flat_sp_tree() = default;
+
+	explicit flat_sp_tree(sp_tree const& t) { // freeze a pointer tree in O(|E|) time; this is the last traversal that needs a stack
+		if (!t.root) return;
+
+		std::stack<std::pair<sp_tree_node const *, int>> hist;
+		hist.emplace(t.root, 0);
+
+		while (!hist.empty()) {
+			sp_tree_node const * curr = hist.top().first;
+			bool leaf = !(curr->l) || !(curr->r);
+
+			if (!leaf && hist.top().second == 0) {
+				hist.top().second = 1;
+				hist.emplace(curr->r, 0); // pushed first so the left subtree is laid out first
+				hist.emplace(curr->l, 0);
+				continue;
+			}
+
+			if (leaf) {
+				if (curr->l || curr->r || curr->comp != c_type::edge) well_formed = false;
+				nodes.push_back({curr->source, curr->sink, 1, c_type::edge});
+			} else {
+				if (curr->comp == c_type::edge) well_formed = false;
+				int r = (int)(nodes.size()) - 1;
+				nodes.push_back({curr->source, curr->sink, 1 + nodes[r].size + nodes[r - nodes[r].size].size, curr->comp});
+			}
+			hist.pop();
+		}
+	}
+
+	bool empty() const {return nodes.empty();}
+	int root() const {return (int)(nodes.size()) - 1;}
+	int right(int i) const {return i - 1;}							  // children of a composed node
+	int left(int i) const {return i - 1 - nodes[i - 1].size;}
+	int subtree_begin(int i) const {return i - nodes[i].size + 1;} // the subtree of node i is exactly the nodes [subtree_begin(i), i], so e.g. the edges under it are the edge nodes in that range
+	int subtree_edges(int i) const {return (nodes[i].size + 1) / 2;} // every composed node has two children, so a subtree with k edges has 2k - 1 nodes
+
+	bool consistent() const { // check the subtree sizes actually describe a single binary tree, so the child lookups above stay in bounds (always true for a tree frozen from an sp_tree)
+		for (int i = 0; i <= root(); i++) {
+			if (nodes[i].comp == c_type::edge) {
+				if (nodes[i].size != 1) return false;
+			} else if (i < 2 || nodes[i - 1].size < 1 || left(i) < 0 || nodes[left(i)].size < 1 || nodes[i].size != 1 + nodes[i - 1].size + nodes[left(i)].size) {
+				return false;
+			}
+		}
+		return !empty() && nodes.back().size == (int)(nodes.size());
+	}
+
+	void deantiparallelize() { // the same as sp_tree::deantiparallelize, on the flat layout
+							   // a node is swapped if an odd number of antiparallel nodes have it under their right child; a swapped node has its source and sink exchanged and its children in the opposite order, which moves its right subtree before its left one in post-order
+							   // so one backward scan works out which nodes are swapped and where every subtree starts in the new layout (both only depend on the parent), and the nodes are then scattered into place
+		int m = (int)(nodes.size());
+		std::vector<char> swapped((size_t)(m), 0);
+		std::vector<int> start((size_t)(m), 0); // first index of each subtree in the new layout
+		std::vector<flat_sp_node> out((size_t)(m));
+
+		for (int i = m - 1; i >= 0; i--) {
+			flat_sp_node node = nodes[i];
+			if (node.comp != c_type::edge) {
+				int l = left(i), r = right(i);
+				swapped[l] = swapped[i];
+				swapped[r] = swapped[i] ^ (node.comp == c_type::antiparallel);
+				int first = (swapped[i] ? r : l), second = (swapped[i] ? l : r);
+				start[first] = start[i];
+				start[second] = start[i] + nodes[first].size;
+				if (node.comp == c_type::antiparallel) node.comp = c_type::parallel;
+			}
+			if (swapped[i]) std::swap(node.source, node.sink);
+			out[start[i] + node.size - 1] = node;
+		}
+
+		nodes = std::move(out);
+	}
+};
+
 struct sp_chain_stack_entry {
 	sp_tree SP;   // an ear with source y and sink x and all ears s*-attached to that ear, represented as an SP decomposition tree SP_(x, y)
 				    // note that though the ear has source y and sink x, the produced SP decomposition has source x and sink y
@@ -221,4 +316,6 @@ struct sp_chain_stack_entry {
 	sp_chain_stack_entry() = default;
 };
 
+using sp_chain_stack = std::stack<sp_chain_stack_entry, std::vector<sp_chain_stack_entry>>; // a per-vertex stack of the above; backed by a vector rather than the default deque, since an empty deque still allocates and we keep one of these for every vertex
+
 #endif
\ No newline at end of file
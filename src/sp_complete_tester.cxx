@@ -1,6 +1,11 @@
 //  SP validation and visualization
 #include "gsp-sp-op.hxx"
 #include "GraphGenerator.hxx"
+#include "corpus-pipeline.hxx"
+#include "graph-normalization.hxx"
+#include "invariance-trials.hxx"
+#include "edge-repair.hxx"
+#include "sp_visualization.hxx"
 #include <random>
 #include <algorithm>
 #include <iostream>
@@ -15,54 +20,24 @@
 using namespace std;
 
 // utility functions
-static void finalize_graph_counts(graph &g) {
-    int cnt = 0;
-    for (int u = 0; u < g.n; ++u) {
-        for (int v : g.adjLists[u]) if (u < v) ++cnt;
-    }
-    g.e = cnt;
+// the invariance tests run on permuted views of the graph rather than copies of it (see invariance-trials.hxx), and compare canonical summaries of the results with the summary of the already authenticated result instead of authenticating every trial
+static unsigned invariance_seed() {
+    thread_local mt19937 rng((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
+    return rng();
 }
 
-static graph relabel_graph_with_perm(graph const& g, const vector<int>& perm) {
-    graph out;
-    out.n = g.n;
-    out.adjLists.resize(out.n);
-    for (int u = 0; u < g.n; ++u) {
-        for (int v : g.adjLists[u]) {
-            if (u < v) out.add_edge(perm[u], perm[v]);
+static bool report_invariance_trials(vector<trial_outcome> const& outcomes, const string& test, const string& what) {
+    for (size_t t = 0; t < outcomes.size(); ++t) {
+        if (!outcomes[t].classified) {
+            cerr << "[" << test << "] Exception in " << what << " " << t << ": " << outcomes[t].error << "\n";
+            return false;
+        }
+        if (!outcomes[t].agrees) {
+            cerr << "[" << test << "] Result mismatch in " << what << " " << t << "\n";
+            return false;
         }
     }
-    finalize_graph_counts(out);
-    return out;
-}
-
-static vector<int> random_permutation(int n) {
-    vector<int> p(n);
-    iota(p.begin(), p.end(), 0);
-    static mt19937_64 rng((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-    shuffle(p.begin(), p.end(), rng);
-    return p;
-}
-
-static vector<int> permutation_map_vertex_to_root(int n, int v) {
-    vector<int> remaining;
-    remaining.reserve(n-1);
-    for (int i=0;i<n;++i) if(i!=v) remaining.push_back(i);
-    static mt19937_64 rng((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-    shuffle(remaining.begin(), remaining.end(), rng);
-    vector<int> perm(n, -1);
-    perm[v] = 0;
-    int idx = 1;
-    for (int x: remaining) perm[x] = idx++;
-    return perm;
-}
-
-static graph shuffle_edge_order(graph g) {
-    static mt19937_64 rng((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-    for (int u = 0; u < g.n; ++u) {
-        shuffle(g.adjLists[u].begin(), g.adjLists[u].end(), rng);
-    }
-    return g;
+    return true;
 }
 
 // validation functions
@@ -107,430 +82,187 @@ bool certificate_authentication_test(graph const& g) {
     return true;
 }
 
-bool vertex_labeling_invariance_test(graph const& g, int trials) {
-    auto base = GSP_SP_OP(g);
-    bool base_sp = base.is_sp;
-    bool base_gsp = base.is_gsp;
-    bool base_op = base.is_op;
-    
-    for (int t = 0; t < trials; ++t) {
-        auto perm = random_permutation(g.n);
-        graph g_perm = relabel_graph_with_perm(g, perm);
-        auto res = GSP_SP_OP(g_perm);
-        
-        if (res.is_sp != base_sp || res.is_gsp != base_gsp || res.is_op != base_op) {
-            cerr << "[vertex_labeling_invariance] Result mismatch in trial " << t << "\n";
-            return false;
-        }
-        
-        bool auth = false;
-        try { 
-            auth = res.authenticate(g_perm); 
-        } catch(...) { 
-            cerr << "[vertex_labeling_invariance] Authentication exception in trial " << t << "\n";
-            return false; 
-        }
-        
-        if (!auth) {
-            cerr << "[vertex_labeling_invariance] Certificate failed to authenticate on permuted graph (trial " << t << ")\n";
-            return false;
-        }
-    }
-    return true;
+bool vertex_labeling_invariance_test(graph const& g, result_summary const& expected, int trials, int threads = 0) {
+    vector<invariance_trial> list;
+    for (int t = 0; t < trials; ++t) list.push_back({true, false, -1, invariance_seed()});
+    return report_invariance_trials(run_invariance_trials(g, expected, list, {threads}), "vertex_labeling_invariance", "trial");
 }
 
-bool edge_ordering_invariance_test(graph const& g, int trials) {
-    auto base = GSP_SP_OP(g);
-    bool base_sp = base.is_sp;
-    bool base_gsp = base.is_gsp;
-    bool base_op = base.is_op;
-    
-    for (int t = 0; t < trials; ++t) {
-        graph g_shuf = shuffle_edge_order(g);
-        auto res = GSP_SP_OP(g_shuf);
-        
-        if (res.is_sp != base_sp || res.is_gsp != base_gsp || res.is_op != base_op) {
-            cerr << "[edge_ordering_invariance] Result mismatch in trial " << t << "\n";
-            return false;
-        }
-        
-        bool auth = false;
-        try { 
-            auth = res.authenticate(g_shuf); 
-        } catch(...) { 
-            cerr << "[edge_ordering_invariance] Authentication exception in trial " << t << "\n";
-            return false; 
-        }
-        
-        if (!auth) {
-            cerr << "[edge_ordering_invariance] Certificate failed to authenticate on shuffled graph (trial " << t << ")\n";
-            return false;
-        }
-    }
-    return true;
+bool edge_ordering_invariance_test(graph const& g, result_summary const& expected, int trials, int threads = 0) {
+    vector<invariance_trial> list;
+    for (int t = 0; t < trials; ++t) list.push_back({false, true, -1, invariance_seed()});
+    return report_invariance_trials(run_invariance_trials(g, expected, list, {threads}), "edge_ordering_invariance", "trial");
 }
 
-bool multiple_root_invariance_test(graph const& g) {
-    auto base = GSP_SP_OP(g);
-    bool base_sp = base.is_sp;
-    bool base_gsp = base.is_gsp;
-    bool base_op = base.is_op;
-    
-    int test_roots = min(g.n, 10); 
-    for (int v = 0; v < test_roots; ++v) {
-        auto perm = permutation_map_vertex_to_root(g.n, v);
-        graph g_perm = relabel_graph_with_perm(g, perm);
-        auto res = GSP_SP_OP(g_perm);
-        
-        if (res.is_sp != base_sp || res.is_gsp != base_gsp || res.is_op != base_op) {
-            cerr << "[multiple_root_invariance] Result mismatch when mapping vertex " << v << " to root\n";
-            return false;
-        }
-    }
-    return true;
+bool multiple_root_invariance_test(graph const& g, result_summary const& expected, int threads = 0) {
+    vector<invariance_trial> list;
+    int test_roots = min(g.n, 10);
+    for (int v = 0; v < test_roots; ++v) list.push_back({true, true, v, invariance_seed()});
+    return report_invariance_trials(run_invariance_trials(g, expected, list, {threads}), "multiple_root_invariance", "root");
 }
 
-//visualization functions
-void draw_graph_dot(graph const& g, const string &filename_png, int node_limit) {
-    if (g.n > node_limit) {
-        cout << "[draw_graph_dot] Graph has " << g.n << " nodes > " << node_limit 
-                  << ", creating simplified representation\n";
-        
-        
-        string dotfile = filename_png + ".dot";
-        ofstream out(dotfile);
-        if (!out) {
-            cerr << "[draw_graph_dot] Cannot open " << dotfile << " for writing\n";
-            return;
-        }
-        
-        out << "digraph LargeGraphSummary {\n";
-        out << "  node [shape=box, fontsize=12];\n";
-        out << "  rankdir=TB;\n\n";
-        out << "  summary [label=\"Large Graph Summary\\n";
-        out << "Vertices: " << g.n << "\\n";
-        out << "Edges: " << g.e << "\\n";
-        if (g.n > 1) {
-            double density = (2.0 * g.e) / ((double)g.n * (g.n - 1));
-            out << "Density: " << fixed << setprecision(4) << density << "\\n";
-        }
-        out << "Too large for full visualization\", shape=note, style=filled, fillcolor=lightyellow];\n";
-        out << "}\n";
-        out.close();
-    } else {
-        //  full graph visualization for smaller graphs
-        string dotfile = filename_png + ".dot";
-        ofstream out(dotfile);
-        if (!out) {
-            cerr << "[draw_graph_dot] Cannot open " << dotfile << " for writing\n";
-            return;
-        }
-        
-        out << "graph G {\n";
-        out << "  node [shape=circle, fontsize=10];\n";
-        out << "  edge [fontsize=8];\n\n";
-        
-        for (int u = 0; u < g.n; ++u) {
-            out << "  " << u << " [label=\"" << u << "\"];\n";
-        }
-        
-        for (int u = 0; u < g.n; ++u) {
-            for (int v : g.adjLists[u]) {
-                if (u < v) {
-                    out << "  " << u << " -- " << v << ";\n";
-                }
+// a permuted_view must read every entry of a scrambled adjacency list exactly once, including the lists whose degree is a multiple of one of the strides it picks from
+bool scrambled_adjacency_test() {
+    vector<int> degrees;
+    for (int d = 1; d <= 64; ++d) degrees.push_back(d);
+    for (int p : {1000003, 1299709}) {
+        degrees.push_back(p);
+        degrees.push_back(2 * p);
+    }
+
+    bool all_passed = true;
+    for (int degree : degrees) {
+        graph star{degree + 1, degree, vector<vector<int>>(degree + 1)}; // only the centre's list is ever read
+        for (int v = 1; v <= degree; ++v) star.adjLists[0].push_back(v);
+        vector<int> identity(degree + 1);
+        for (int v = 0; v <= degree; ++v) identity[v] = v;
+
+        vector<int> seen(degree + 1, -1);
+        for (uint64_t order = 1; order <= 16; ++order) {
+            permuted_view view{&star, star.n, star.e, identity.data(), identity.data(), order};
+            int count = 0, i = 0;
+            bool ok = true;
+            for (int u : view.neighbors(0)) {
+                ok = ok && u >= 1 && u <= degree && seen[u] != (int)order && view.neighbor(0, i++) == u;
+                seen[u] = (int)order;
+                count++;
+            }
+            if (!ok || count != degree) {
+                cout << "  scrambled_adjacency: degree " << degree << ", order " << order << " does not read the list as a permutation\n";
+                all_passed = false;
+                break;
             }
         }
-        
-        out << "}\n";
-        out.close();
-    }
-    
-  
-    string dotfile = filename_png + ".dot";
-    string cmd = "dot -Tpng \"" + dotfile + "\" -o \"" + filename_png + "\" 2>/dev/null";
-    int rc = system(cmd.c_str());
-    if (rc != 0) {
-        cerr << "[draw_graph_dot] dot command failed (rc=" << rc << ")\n";
-        cerr << "[draw_graph_dot] Make sure Graphviz is installed: sudo apt-get install graphviz\n";
-        cerr << "[draw_graph_dot] DOT file available at: " << dotfile << "\n";
-    } else {
-        cout << "[draw_graph_dot] Created visualization: " << filename_png << "\n";
     }
+    cout << "  scrambled_adjacency: " << (all_passed ? "PASSED" : "FAILED") << "\n";
+    return all_passed;
 }
 
-void draw_decomposition_certificate_dot(gsp_sp_op_result const& result, const string &filename_png) {
-    string dotfile = filename_png + ".dot";
-    ofstream out(dotfile);
-    if (!out) {
-        cerr << "[draw_decomposition_certificate_dot] Cannot open dot file\n";
-        return;
-    }
-    
-    out << "digraph SPCertificate {\n";
-    out << "  node [fontsize=12, style=filled];\n";
-    out << "  rankdir=TB;\n\n";
-    
-    // Main result node
-    out << "  result [label=\"Algorithm Results\\n";
-    out << "GSP: " << (result.is_gsp ? "YES" : "NO") << "\\n";
-    out << "SP: " << (result.is_sp ? "YES" : "NO") << "\\n"; 
-    out << "OP: " << (result.is_op ? "YES" : "NO") << "\", ";
-    out << "shape=record, fillcolor=" << (result.is_sp ? "lightgreen" : "lightcoral") << "];\n\n";
-    
-    // Certificate information
-    if (result.sp_reason) {
-        out << "  sp_cert [label=\"SP Certificate\\nPresent & Authenticated\", shape=box, fillcolor=palegreen];\n";
-        out << "  result -> sp_cert;\n";
-    }
-    
-    if (result.gsp_reason && result.gsp_reason != result.sp_reason) {
-        out << "  gsp_cert [label=\"GSP Certificate\\nPresent & Authenticated\", shape=box, fillcolor=lightblue];\n";  
-        out << "  result -> gsp_cert;\n";
-    }
-    
-    if (result.op_reason && result.op_reason != result.sp_reason && result.op_reason != result.gsp_reason) {
-        out << "  op_cert [label=\"OP Certificate\\nPresent & Authenticated\", shape=box, fillcolor=lightyellow];\n";
-        out << "  result -> op_cert;\n";
-    }
-    
-    // Decomposition information
-    if (result.is_sp) {
-        out << "  decomp [label=\"SP Decomposition Tree\\nAvailable via Certificate\", shape=diamond, fillcolor=gold];\n";
-        out << "  result -> decomp;\n";
-    } else {
-        out << "  no_decomp [label=\"No SP Decomposition\\nNegative Certificate Explains Why\", shape=diamond, fillcolor=pink];\n";
-        out << "  result -> no_decomp;\n";
-    }
-    
-    out << "}\n";
-    out.close();
-    
-    string cmd = "dot -Tpng \"" + dotfile + "\" -o \"" + filename_png + "\" 2>/dev/null";
-    int rc = system(cmd.c_str());
-    if (rc != 0) {
-        cerr << "[draw_decomposition_certificate_dot] dot failed (rc=" << rc << ")\n";
-        cerr << "[draw_decomposition_certificate_dot] DOT file available at: " << dotfile << "\n";
-    } else {
-        cout << "[draw_decomposition_certificate_dot] Created certificate diagram: " << filename_png << "\n";
+// a repair must only remove edges of the input, and leave a graph of the target class whose certificate authenticates; inputs GSP_SP_OP can't take must be refused without removing anything
+static bool valid_repair(graph const& g, repair_result const& r, repair_target target) {
+    if (!r.repaired || r.g.e != g.e - (int)r.removed.size()) return false;
+    for (edge_t e : r.removed) {
+        if (!g.adjacent(e.first, e.second) || r.g.adjacent(e.first, e.second)) return false;
     }
+    return (target == repair_target::gsp ? r.result.is_gsp : r.result.is_op) && r.result.authenticate(r.g);
 }
 
-void draw_detailed_sp_tree(gsp_sp_op_result const& result, const string &filename_png) {
-    string dotfile = filename_png + ".dot";
-    ofstream out(dotfile);
-    if (!out) {
-        cerr << "[draw_detailed_sp_tree] Cannot open dot file\n";
-        return;
-    }
-    
-    out << "digraph SPDecomposition {\n";
-    out << "  node [fontsize=10, style=filled];\n";
-    out << "  rankdir=TB;\n\n";
-    
-    if (result.is_sp && result.sp_reason) {
-        
-        auto gsp_cert = std::dynamic_pointer_cast<positive_cert_gsp>(result.sp_reason);
-        if (gsp_cert) {
-            out << "  // REAL SP Decomposition Tree from Certificate\n";
-            out << "  root [label=\"SP Decomposition\\nFrom Certificate\", shape=diamond, fillcolor=gold];\n\n";
-            
-            // certificate info
-            out << "  cert_info [label=\"Certificate Type: Positive GSP\\nTree authenticated and valid\\n";
-            if (gsp_cert->is_sp) {
-                out << "Is SP: TRUE\", shape=box, fillcolor=lightgreen];\n";
-            } else {
-                out << "Is SP: FALSE\", shape=box, fillcolor=lightblue];\n";
-            }
-            out << "  root -> cert_info;\n\n";
-            
-            
-            out << "  decomp_note [label=\"SP Decomposition Tree Structure:\\n";
-            out << "• Series operations (end-to-end)\\n";
-            out << "• Parallel operations (same endpoints)\\n";  
-            out << "• Base edges (graph components)\\n";
-            out << "\\nCertificate contains complete\\ndecomposition details\", shape=note, fillcolor=lightyellow];\n";
-            out << "  root -> decomp_note;\n";
-            
-        } else {
-            // Fallback if can't access the decomposition structure
-            out << "  root [label=\"SP Decomposition\\nExists but certificate\\ntype not accessible\", shape=diamond, fillcolor=gold];\n";
-        }
-        
-    } else {
-        
-        out << "  // Graph is NOT Series-Parallel\n";
-        out << "  root [label=\"NOT Series-Parallel\\nNo Decomposition Exists\", shape=box, fillcolor=lightcoral];\n\n";
-        
-        if (result.sp_reason) {
-            // Trying to identify the type of negative certificate
-            string cert_type = "Unknown";
-            string reason_detail = "Unspecified reason";
-            
-            if (std::dynamic_pointer_cast<negative_cert_K4>(result.sp_reason)) {
-                cert_type = "K4 Subdivision";
-                reason_detail = "Contains a subdivision of K4\\n(complete graph on 4 vertices)";
-            } else if (std::dynamic_pointer_cast<negative_cert_K23>(result.sp_reason)) {
-                cert_type = "K2,3 Subdivision";  
-                reason_detail = "Contains a subdivision of K2,3\\n(complete bipartite graph)";
-            } else if (std::dynamic_pointer_cast<negative_cert_T4>(result.sp_reason)) {
-                cert_type = "T4 Subdivision";
-                reason_detail = "Contains a T4 structure\\n(K4 with edge removed)";
-            } else if (std::dynamic_pointer_cast<negative_cert_tri_comp_cut>(result.sp_reason)) {
-                cert_type = "Triple Component Cut";
-                reason_detail = "Cut vertex in 3+ components";
-            } else if (std::dynamic_pointer_cast<negative_cert_tri_cut_comp>(result.sp_reason)) {
-                cert_type = "Triple Cut Component";
-                reason_detail = "Component with 3+ cut vertices";
-            }
-            
-            out << "  negative [label=\"Negative Certificate\\nType: " << cert_type << "\\n" 
-                << reason_detail << "\", shape=diamond, fillcolor=pink];\n";
-            out << "  root -> negative;\n";
+static graph graph_from_edges(int n, vector<edge_t> const& edges) {
+    graph g{n, (int)edges.size(), vector<vector<int>>(n)};
+    for (edge_t e : edges) g.add_edge(e.first, e.second);
+    return g;
+}
+
+bool edge_repair_test() {
+    bool all_passed = true;
+    auto expect = [&](bool ok, const string& what) {
+        if (!ok) {
+            cout << "  edge_repair: " << what << "\n";
+            all_passed = false;
         }
-        
-        out << "  explanation [label=\"Series-Parallel graphs can only be built using:\\n";
-        out << "• Series composition (end-to-end)\\n• Parallel composition (same endpoints)\\n";
-        out << "• Starting from single edges\\n\\nThis graph requires operations\\nnot allowed in SP construction\", ";
-        out << "shape=note, fillcolor=lightyellow];\n";
-        out << "  root -> explanation [style=dashed];\n";
+    };
+
+    vector<graph> refused = {
+        graph_from_edges(6, {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}}), // two triangles
+        graph_from_edges(1, {}),
+        graph_from_edges(0, {})
+    };
+    for (graph const& g : refused) {
+        repair_result r = repair_graph(g);
+        expect(!r.repaired && !r.error.empty() && r.removed.empty(), "a graph with " + to_string(g.n) + " vertices and " + to_string(g.e) + " edges was not refused");
     }
-    
-    out << "}\n";
-    out.close();
-    
-    string cmd = "dot -Tpng \"" + dotfile + "\" -o \"" + filename_png + "\" 2>/dev/null";
-    int rc = system(cmd.c_str());
-    if (rc != 0) {
-        cerr << "[draw_detailed_sp_tree] dot failed (rc=" << rc << ")\n"; 
-        cerr << "[draw_detailed_sp_tree] DOT file available at: " << dotfile << "\n";
-    } else {
-        cout << "[draw_detailed_sp_tree] Created SP tree diagram: " << filename_png << "\n";
+
+    graph k4 = graph_from_edges(4, {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}});
+    expect(dynamic_cast<negative_cert_K4*>(GSP_SP_OP(k4).op_reason.get()) != nullptr, "K4 did not give a K4 as its op_reason");
+    expect(valid_repair(k4, repair_graph(k4, {repair_target::op}), repair_target::op), "K4 was not repaired to OP");
+
+    for (int i = 0; i < 40; ++i) {
+        graph g = generate_graph(2 + i % 5, 3 + i % 4, 1 + i % 4, 4 + i % 3, i % 2, 1000 + i);
+        for (repair_target target : {repair_target::gsp, repair_target::op}) {
+            repair_config config{target, 4 + i % 8, 2 + i % 3};
+            expect(valid_repair(g, repair_graph(g, config), target), "generated graph " + to_string(i) + " was not repaired to " + (target == repair_target::gsp ? "GSP" : "OP"));
+        }
     }
+
+    cout << "  edge_repair: " << (all_passed ? "PASSED" : "FAILED") << "\n";
+    return all_passed;
 }
 
-void create_complete_sp_visualization(graph const& g, gsp_sp_op_result const& result, const string &base_filename) {
-    cout << "\n=== Creating Complete SP Visualization Suite ===\n";
-    cout << "Base filename: " << base_filename << endl;
-    
-    //  graph visualization
-    string graph_file = base_filename + "_graph.png";
-    draw_graph_dot(g, graph_file, 600); 
-    
-    // Generate certificate diagram  
-    string cert_file = base_filename + "_certificate.png";
-    draw_decomposition_certificate_dot(result, cert_file);
-    
-    // Generate decomposition tree
-    string tree_file = base_filename + "_sp_tree.png";
-    draw_detailed_sp_tree(result, tree_file);
-    
-    //   summary
-    string summary_file = base_filename + "_analysis.txt";
-    ofstream summary(summary_file);
-    if (summary) {
-        summary << "SP Graph Analysis - Complete Report\n";
-        summary << "===================================\n\n";
-        
-        summary << "Input Graph Properties:\n";
-        summary << "  Vertices (n): " << g.n << "\n";
-        summary << "  Edges (e): " << g.e << "\n";
-        if (g.n > 1) {
-            double density = (2.0 * g.e) / ((double)g.n * (g.n - 1));
-            summary << "  Graph Density: " << fixed << setprecision(6) << density << "\n";
+// a classifier resumed a little at a time must give the result GSP_SP_OP does, and one that's cancelled (or whose result was already taken) must give no result
+bool resumable_classifier_test() {
+    bool all_passed = true;
+    auto expect = [&](bool ok, const string& what) {
+        if (!ok) {
+            cout << "  resumable_classifier: " << what << "\n";
+            all_passed = false;
         }
-        summary << "  Average Degree: " << fixed << setprecision(2) << (2.0 * g.e) / g.n << "\n\n";
-        
-        summary << "Algorithm Classification Results:\n";
-        summary << "  Generalized Series-Parallel (GSP): " << (result.is_gsp ? "TRUE" : "FALSE") << "\n";
-        summary << "  Series-Parallel (SP): " << (result.is_sp ? "TRUE" : "FALSE") << "\n";
-        summary << "  Outerplanar (OP): " << (result.is_op ? "TRUE" : "FALSE") << "\n\n";
-        
-        summary << "Certificate Status:\n";
-        bool auth_success = false;
-        try {
-            auth_success = result.authenticate(g);
-        } catch(...) {
-            auth_success = false;
-        }
-        summary << "  Overall Authentication: " << (auth_success ? "PASSED" : "FAILED") << "\n";
-        summary << "  GSP Certificate: " << (result.gsp_reason ? "Present" : "None") << "\n";
-        summary << "  SP Certificate: " << (result.sp_reason ? "Present" : "None") << "\n";
-        summary << "  OP Certificate: " << (result.op_reason ? "Present" : "None") << "\n\n";
-        
-        summary << "Generated Visualization Files:\n";
-        summary << "  Graph Structure: " << graph_file << "\n";
-        summary << "  Certificate Diagram: " << cert_file << "\n";
-        summary << "  SP Tree Structure: " << tree_file << "\n";
-        summary << "  DOT Source Files: " << base_filename << "_*.dot\n\n";
-        
-        if (result.is_sp) {
-            summary << "Interpretation:\n";
-            summary << "  This graph IS series-parallel, meaning it can be constructed\n";
-            summary << "  using only series and parallel operations on edges.\n";
-            summary << "  It has an SP decomposition tree showing this construction.\n";
-        } else {
-            summary << "Interpretation:\n";
-            summary << "  This graph is NOT series-parallel, meaning it contains\n";
-            summary << "  structural patterns that cannot be built using only\n";
-            summary << "  series and parallel operations on edges.\n";
-            if (result.sp_reason) {
-                summary << "  The negative certificate explains the specific reason\n";
-                summary << "  (e.g., forbidden subgraph like K4 or K2,3).\n";
-            }
-        }
-        
-        summary << "\nValidation Tests Performed:\n";
-        summary << "  - Certificate authentication\n";
-        summary << "  - Vertex labeling invariance\n";
-        summary << "  - Edge ordering invariance\n";
-        summary << "  - Multiple root invariance\n";
-        summary << "  - Graph structure validation\n";
-        
-        summary.close();
-        cout << "Complete analysis written to: " << summary_file << endl;
+    };
+
+    for (int i = 0; i < 20; ++i) {
+        graph g = generate_graph(2 + i % 5, 3 + i % 4, i % 2, 4 + i % 3, i % 2, 2000 + i);
+        gsp_sp_op_classifier c{g};
+        expect(!c.result(), "generated graph " + to_string(i) + " gave a result before it was classified");
+        while (!c.resume(1 + i)) {}
+        optional<gsp_sp_op_result> r = c.result();
+        gsp_sp_op_result direct = GSP_SP_OP(g);
+        expect(r && r->is_gsp == direct.is_gsp && r->is_sp == direct.is_sp && r->is_op == direct.is_op && r->authenticate(g), "generated graph " + to_string(i) + " was classified differently in steps");
+        expect(!c.result(), "generated graph " + to_string(i) + " gave its result twice");
+
+        gsp_sp_op_classifier cancelled{g};
+        cancelled.resume(1 + i);
+        cancelled.cancel();
+        expect(cancelled.resume(1 + i) && (cancelled.cancelled() ? !cancelled.result() : (bool)cancelled.result()), "generated graph " + to_string(i) + " gave a result after it was cancelled");
     }
-    
-    cout << "Visualization suite completed!\n";
+
+    cout << "  resumable_classifier: " << (all_passed ? "PASSED" : "FAILED") << "\n";
+    return all_passed;
 }
 
 //  MAIN VALIDATION FUNCTIONS
-void run_comprehensive_sp_validation(graph const& g, const string &test_name) {
-    cout << "\n=== " << test_name << " ===\n";
-    cout << "Graph: n=" << g.n << ", e=" << g.e << endl;
-    
-    
-    auto result = GSP_SP_OP(g);
-    cout << "Algorithm results: GSP=" << result.is_gsp 
-         << ", SP=" << result.is_sp << ", OP=" << result.is_op << endl;
-    
+
+// Tasks 2-4 for an already classified graph; returns false if the certificate failed to authenticate (nothing should be drawn then)
+// threads is how many threads the invariance trials get (0 for one per hardware thread)
+bool run_sp_validation_checks(graph const& g, gsp_sp_op_result const& result, bool cert_auth, const string &test_name, ostream& out, int threads = 0) {
+    out << "\n=== " << test_name << " ===\n";
+    out << "Graph: n=" << g.n << ", e=" << g.e << endl;
+
+    out << "Algorithm results: GSP=" << result.is_gsp
+        << ", SP=" << result.is_sp << ", OP=" << result.is_op << endl;
+
     // Task 2: Certificate Authentication
-    cout << "  Testing certificate authentication... ";
-    bool cert_auth = certificate_authentication_test(g);
-    cout << (cert_auth ? "PASSED" : "FAILED") << endl;
-    if (!cert_auth) return;
-    
+    out << "  Testing certificate authentication... ";
+    out << (cert_auth ? "PASSED" : "FAILED") << endl;
+    if (!cert_auth) return false;
+
     // Task 3: Output Same Everywhere on Graph (labeling and edge ordering invariance)
-    cout << "  Testing labeling and edge ordering invariance... ";
-    bool label_inv = vertex_labeling_invariance_test(g, 5);
-    bool edge_inv = edge_ordering_invariance_test(g, 5);
-    cout << ((label_inv && edge_inv) ? "PASSED" : "FAILED") << endl;
-    
+    out << "  Testing labeling and edge ordering invariance... ";
+    result_summary expected = summarize_result(result);
+    bool label_inv = vertex_labeling_invariance_test(g, expected, 5, threads);
+    bool edge_inv = edge_ordering_invariance_test(g, expected, 5, threads);
+    out << ((label_inv && edge_inv) ? "PASSED" : "FAILED") << endl;
+
     // Task 4: Output Same from Anywhere on Graph (multiple root invariance)
-    cout << "  Testing multiple root invariance and adjacency validation... ";
-    bool root_inv = multiple_root_invariance_test(g);
+    out << "  Testing multiple root invariance and adjacency validation... ";
+    bool root_inv = multiple_root_invariance_test(g, expected, threads);
     bool adj_valid = adjacency_list_validation(g);
-    cout << ((root_inv && adj_valid) ? "PASSED" : "FAILED") << endl;
-    
+    out << ((root_inv && adj_valid) ? "PASSED" : "FAILED") << endl;
+
+    bool all_passed = cert_auth && label_inv && edge_inv && root_inv && adj_valid;
+    out << "Test Result: " << (all_passed ? "ALL PASSED" : "SOME FAILED") << endl;
+    return true;
+}
+
+void run_comprehensive_sp_validation(graph const& g, const string &test_name) {
+    auto result = GSP_SP_OP(g);
+    bool cert_auth = certificate_authentication_test(g);
+    if (!run_sp_validation_checks(g, result, cert_auth, test_name, cout)) return;
+
     // Task 5: Draw the SP Graph & Decomposition Tree
     cout << "  Creating visualization and analysis... ";
     string viz_base = test_name;
     replace(viz_base.begin(), viz_base.end(), ' ', '_');
     create_complete_sp_visualization(g, result, viz_base);
     cout << "COMPLETED" << endl;
-    
-    bool all_passed = cert_auth && label_inv && edge_inv && root_inv && adj_valid;
-    cout << "Test Result: " << (all_passed ? "ALL PASSED" : "SOME FAILED") << endl;
 }
 
 void run_validation_tests_with_generator() {
@@ -558,7 +290,7 @@ void run_validation_tests_with_generator() {
            
             long seed = chrono::high_resolution_clock::now().time_since_epoch().count() + (i * 7919);
             graph g = generate_graph(nC, lC, nK, lK, three_edges, seed);
-            finalize_graph_counts(g);
+            normalize_graph(g);
             
             cout << "Generated graph: n=" << g.n << ", e=" << g.e << endl;
             
@@ -574,7 +306,7 @@ void run_validation_tests_with_generator() {
       
         long seed = chrono::high_resolution_clock::now().time_since_epoch().count() + 999999;
         graph large_g = generate_graph(100, 4, 50, 3, 0, seed);
-        finalize_graph_counts(large_g);
+        normalize_graph(large_g);
         
         cout << "\n--- Large Graph Test ---\n";
         cout << "Generated large graph: n=" << large_g.n << ", e=" << large_g.e << endl;
@@ -594,36 +326,37 @@ void test_directory_graphs(const string& directory) {
         return;
     }
     
+    // files are read, parsed, classified and drawn by separate stages running in parallel (see corpus-pipeline.hxx), but reported in sorted file order
+    vector<filesystem::path> files = list_corpus_files(directory);
+    vector<string> viz_logs(files.size());
     int file_count = 0;
-    for (const auto& entry : filesystem::directory_iterator(directory)) {
-        if (entry.path().extension() == ".txt") {
-            string filepath = entry.path().string();
-            string filename = entry.path().stem().string();
-            
-            cout << "\n--- Testing file: " << filename << " ---\n";
-            
-            ifstream file(filepath);
-            if (!file) {
-                cerr << "Error: Cannot open file " << filepath << "\n";
-                continue;
-            }
-            
-            graph g;
-            try {
-                file >> g;
-                file.close();
-                cout << "Loaded graph: n=" << g.n << ", e=" << g.e << endl;
-                
-                run_comprehensive_sp_validation(g, filename);
-                file_count++;
-                
-            } catch (const exception& e) {
-                cerr << "Error processing " << filepath << ": " << e.what() << "\n";
-                continue;
+
+    corpus_pipeline_report stats = run_corpus_pipeline(files, corpus_pipeline_config{},
+        [](corpus_item& item) { // classifier threads: tasks 2-4 (with the invariance trials on the same thread, since the pipeline already keeps every core busy), buffered so the output doesn't interleave
+            ostringstream out;
+            out << "Loaded graph: n=" << item.g.n << ", e=" << item.g.e << endl;
+            if (!run_sp_validation_checks(item.g, item.result, item.authenticated, item.path.stem().string(), out, 1)) item.error = "certificate authentication failed";
+            item.report = out.str();
+        },
+        [&](corpus_item& item) { // calling thread, in file order
+            cout << "\n--- Testing file: " << item.path.stem().string() << " ---\n";
+            if (!item.loaded) {
+                cerr << "Error processing " << item.path.string() << ": " << item.error << "\n";
+                return;
             }
-        }
-    }
-    
+            cout << item.report;
+            file_count++;
+        },
+        [&](corpus_item& item) { // low-priority visualizer threads, task 5
+            ostringstream log;
+            create_complete_sp_visualization(item.g, item.result, item.path.stem().string(), log);
+            viz_logs[item.index] = log.str();
+        });
+
+    for (string const& log : viz_logs) cout << log;
+    cout << "\n";
+    stats.print(cout);
+
     if (file_count == 0) {
         cout << "No .txt files found in directory " << directory << "\n";
     } else {
@@ -650,8 +383,20 @@ int main(int argc, char* argv[]) {
         cout << "No directory specified. Running generated graph tests only.\n";
     }
     
+    cout << "=== Scrambled Adjacency Lists ===\n";
+    scrambled_adjacency_test();
+    cout << "\n";
+
+    cout << "=== Edge Repair ===\n";
+    edge_repair_test();
+    cout << "\n";
+
+    cout << "=== Resumable Classification ===\n";
+    resumable_classifier_test();
+    cout << "\n";
+
     run_validation_tests_with_generator();
-    
+
     cout << "\n=== SP Graph Testing Complete ===\n";
     cout << "Check generated files:\n";
     cout << " - *.png files for visualizations\n";
@@ -0,0 +1,200 @@
+// this checks the DP solvers in sp-dp.hxx against generic (exponential or cubic) solvers on random GSP graphs, and then times both
+// optional command line argument: the order of the largest graph to run the DP on alone (default 1000000)
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "sp-dp.hxx"
+#include "benchmark-util.hxx"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// ---------------- generic baselines ----------------
+
+long long brute_mwis(graph const& g, std::vector<long long> const& w) { // exhaustive search with include/exclude branching on vertices in order
+	std::vector<uint64_t> adj((size_t)(g.n), 0);
+	for (int v = 0; v < g.n; v++) {
+		for (int u : g.adjLists[v]) adj[v] |= uint64_t{1} << u;
+	}
+
+	long long best = 0;
+	auto go = [&](auto&& self, int v, uint64_t chosen, long long weight) -> void {
+		if (v == g.n) {
+			best = std::max(best, weight);
+			return;
+		}
+		self(self, v + 1, chosen, weight);
+		if (!(adj[v] & chosen)) self(self, v + 1, chosen | (uint64_t{1} << v), weight + w[v]);
+	};
+	go(go, 0, 0, 0);
+	return best;
+}
+
+uint64_t brute_three_colorings(graph const& g) { // backtracking count of proper 3-colourings
+	std::vector<int> color((size_t)(g.n), -1);
+	auto go = [&](auto&& self, int v) -> uint64_t {
+		if (v == g.n) return 1;
+		uint64_t count = 0;
+		for (int c = 0; c < 3; c++) {
+			bool ok = true;
+			for (int u : g.adjLists[v]) ok = ok && color[u] != c;
+			if (!ok) continue;
+			color[v] = c;
+			count += self(self, v + 1);
+			color[v] = -1;
+		}
+		return count;
+	};
+	return go(go, 0);
+}
+
+uint64_t mod_pow(uint64_t b, uint64_t e, uint64_t m) {
+	uint64_t r = 1 % m;
+	for (b %= m; e; e >>= 1, b = b * b % m) {
+		if (e & 1) r = r * b % m;
+	}
+	return r;
+}
+
+uint64_t kirchhoff_spanning_trees(graph const& g, uint64_t p = 1000000007) { // matrix-tree theorem: determinant of the reduced Laplacian, by Gaussian elimination mod p
+	int m = g.n - 1;
+	if (m <= 0) return 1 % p;
+
+	std::vector<std::vector<uint64_t>> a((size_t)(m), std::vector<uint64_t>((size_t)(m), 0));
+	for (int v = 1; v < g.n; v++) {
+		a[v - 1][v - 1] = g.adjLists[v].size() % p;
+		for (int u : g.adjLists[v]) {
+			if (u != 0) a[v - 1][u - 1] = (a[v - 1][u - 1] + p - 1) % p;
+		}
+	}
+
+	uint64_t det = 1;
+	for (int c = 0; c < m; c++) {
+		int pivot = c;
+		while (pivot < m && a[pivot][c] == 0) pivot++;
+		if (pivot == m) return 0;
+		if (pivot != c) {
+			std::swap(a[pivot], a[c]);
+			det = (p - det) % p;
+		}
+
+		det = det * a[c][c] % p;
+		uint64_t inv = mod_pow(a[c][c], p - 2, p);
+		for (int r = c + 1; r < m; r++) {
+			if (a[r][c] == 0) continue;
+			uint64_t f = a[r][c] * inv % p;
+			for (int k = c; k < m; k++) a[r][k] = (a[r][k] + (p - f) * a[c][k]) % p;
+		}
+	}
+	return det;
+}
+
+// ---------------- driver ----------------
+
+int main(int argc, char ** argv) {
+	int big = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	std::mt19937 rng{12345};
+
+	std::cout << "====== CORRECTNESS (random GSP graphs on 2 to 16 vertices) ======\n";
+	int failures = 0;
+	for (int i = 0; i < 2000; i++) {
+		int n = 2 + (int)(rng() % 15);
+		graph g = random_gsp_graph(n, (unsigned)(i), i % 2);
+		gsp_sp_op_result r = GSP_SP_OP(g);
+		flat_sp_tree const * tree = gsp_decomposition(r);
+		if (!tree) {
+			std::cout << "graph " << i << " was not recognized as GSP\n";
+			failures++;
+			continue;
+		}
+		flat_sp_tree const& t = *tree;
+
+		std::vector<long long> w((size_t)(n));
+		for (long long& x : w) x = (long long)(rng() % 100);
+		long long total = std::accumulate(w.begin(), w.end(), 0LL);
+
+		sp_vertex_set is = sp_max_weight_independent_set(t, w);
+		sp_vertex_set vc = sp_min_weight_vertex_cover(t, w);
+		std::vector<int> color = sp_three_coloring(t, n);
+		std::vector<bool> in_is((size_t)(n), false), in_vc((size_t)(n), false);
+		for (int v : is.vertices) in_is[v] = true;
+		for (int v : vc.vertices) in_vc[v] = true;
+
+		bool ok = is.weight == brute_mwis(g, w) && vc.weight == total - is.weight &&
+				  sp_count_three_colorings(t, n) == brute_three_colorings(g) &&
+				  sp_count_spanning_trees(t, n) == kirchhoff_spanning_trees(g) && (int)(color.size()) == n;
+		for (int v = 0; v < n && ok; v++) {
+			for (int u : g.adjLists[v]) ok = ok && !(in_is[u] && in_is[v]) && (in_vc[u] || in_vc[v]) && color[u] != color[v];
+		}
+
+		if (!ok) {
+			std::cout << "mismatch on graph " << i << " (" << n << " vertices)\n";
+			failures++;
+		}
+	}
+	std::cout << (failures ? "FAILED" : "all agree") << "\n\n";
+
+	std::cout << "====== DP vs GENERIC ======\n" << std::fixed << std::setprecision(6);
+	for (int n : {16, 20, 24, 28}) {
+		graph g = random_gsp_graph(n, (unsigned)(n));
+		gsp_sp_op_result r = GSP_SP_OP(g);
+		flat_sp_tree const& t = *gsp_decomposition(r);
+		std::vector<long long> w((size_t)(n), 1);
+
+		auto start = std::chrono::steady_clock::now();
+		long long dp_is = sp_max_weight_independent_set(t, w).weight;
+		uint64_t dp_col = sp_count_three_colorings(t, n);
+		double dp_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		long long bf_is = brute_mwis(g, w);
+		uint64_t bf_col = brute_three_colorings(g);
+		double bf_time = seconds_since(start);
+
+		std::cout << "n = " << std::setw(7) << n << "   MWIS + 3-colourings: DP " << dp_time << "s, exhaustive " << bf_time << "s" << (dp_is == bf_is && dp_col == bf_col ? "" : "   MISMATCH") << "\n";
+	}
+	for (int n : {100, 200, 400, 800}) {
+		graph g = random_gsp_graph(n, (unsigned)(n));
+		gsp_sp_op_result r = GSP_SP_OP(g);
+		flat_sp_tree const& t = *gsp_decomposition(r);
+
+		auto start = std::chrono::steady_clock::now();
+		uint64_t dp_st = sp_count_spanning_trees(t, n);
+		double dp_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		uint64_t det_st = kirchhoff_spanning_trees(g);
+		double det_time = seconds_since(start);
+
+		std::cout << "n = " << std::setw(7) << n << "   spanning trees:      DP " << dp_time << "s, Kirchhoff " << det_time << "s" << (dp_st == det_st ? "" : "   MISMATCH") << "\n";
+	}
+
+	std::cout << "\n====== DP ALONE (" << big << " vertices) ======\n";
+	graph g = random_gsp_graph(big, 1);
+	auto start = std::chrono::steady_clock::now();
+	gsp_sp_op_result r = GSP_SP_OP(g);
+	std::cout << "GSP_SP_OP:                 " << seconds_since(start) << "s\n";
+	flat_sp_tree const& t = *gsp_decomposition(r);
+	std::cout << "decomposition:              " << t.nodes.size() << " nodes\n";
+	std::vector<long long> w((size_t)(big), 1);
+
+	start = std::chrono::steady_clock::now();
+	long long is_weight = sp_max_weight_independent_set(t, w).weight;
+	std::cout << "max weight independent set: " << seconds_since(start) << "s (weight " << is_weight << ")\n";
+	start = std::chrono::steady_clock::now();
+	long long vc_weight = sp_min_weight_vertex_cover(t, w).weight;
+	std::cout << "min weight vertex cover:    " << seconds_since(start) << "s (weight " << vc_weight << ")\n";
+	start = std::chrono::steady_clock::now();
+	uint64_t colorings = sp_count_three_colorings(t, big);
+	std::cout << "3-colourings (mod 1e9+7):   " << seconds_since(start) << "s (" << colorings << ")\n";
+	start = std::chrono::steady_clock::now();
+	uint64_t trees = sp_count_spanning_trees(t, big);
+	std::cout << "spanning trees (mod 1e9+7): " << seconds_since(start) << "s (" << trees << ")\n";
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+// this file contains a batch API for classifying many induced subgraphs of one host graph in parallel, e.g. every neighbourhood or every window of a large graph
+// the subgraphs are never built; each worker thread binds them one at a time as subgraph_views (see graph.hxx) over the shared, read-only host, so the host is never copied and a subset costs only its own size to set up
+
+#ifndef __SUBGRAPH_BATCH_HXX__
+#define __SUBGRAPH_BATCH_HXX__
+
+#include "graph.hxx"
+#include "gsp-sp-op.hxx"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct subgraph_batch_config {
+	int threads = 0;			// 0 means one per hardware thread
+	bool authenticate = false;	// authenticate each result against its view
+	bool keep_results = false;	// keep the certificates (their vertices are local to the view, so vertex v is subsets[i][v] in the host); otherwise only the flags are kept
+};
+
+struct subgraph_result {
+	bool classified = false;	// false if the subset was invalid (out of range or repeated vertices), had fewer than 2 vertices, or induced a disconnected subgraph, none of which GSP_SP_OP handles
+	bool is_gsp = false;
+	bool is_sp = false;
+	bool is_op = false;
+	bool authenticated = false; // true if the result was authenticated against the view (only with config.authenticate)
+	std::string error;			// set if the subset couldn't be classified, saying why
+	gsp_sp_op_result result{};	// only with config.keep_results
+};
+
+bool view_connected(subgraph_view const& view, std::vector<int>& stack, std::vector<char>& seen) { // check a view is connected with a DFS from local vertex 0, using the caller's scratch space
+	stack.clear();
+	seen.assign((size_t)(view.n), false);
+	stack.push_back(0);
+	seen[0] = true;
+	int reached = 1;
+
+	while (!stack.empty()) {
+		int w = stack.back();
+		stack.pop_back();
+
+		for (int u : view.neighbors(w)) {
+			if (!seen[u]) {
+				seen[u] = true;
+				reached++;
+				stack.push_back(u);
+			}
+		}
+	}
+
+	return reached == view.n;
+}
+
+subgraph_result classify_subgraph(subgraph_workspace& workspace, std::vector<int> const& subset, subgraph_batch_config const& config, std::vector<int>& stack, std::vector<char>& seen) { // classify one subset, with the view bound to workspace for the duration
+	subgraph_result r;
+	subgraph_view view;
+
+	if (!workspace.bind(subset, view)) {
+		r.error = "subset has a vertex out of range or repeated";
+		return r;
+	}
+
+	if (view.n < 2) {
+		r.error = "subset has fewer than 2 vertices";
+	} else if (!view_connected(view, stack, seen)) {
+		r.error = "subset induces a disconnected subgraph";
+	} else {
+		try {
+			gsp_sp_op_result result = GSP_SP_OP(view);
+			r.classified = true;
+			r.is_gsp = result.is_gsp;
+			r.is_sp = result.is_sp;
+			r.is_op = result.is_op;
+			if (config.authenticate) r.authenticated = result.authenticate(view);
+			if (config.keep_results) r.result = std::move(result);
+		} catch (std::exception const& ex) {
+			r.classified = false;
+			r.error = ex.what();
+		} catch (...) {
+			r.classified = false;
+			r.error = "unknown exception during classification";
+		}
+	}
+
+	workspace.unbind();
+	return r;
+}
+
+std::vector<subgraph_result> classify_subgraphs(graph const& host, std::vector<std::vector<int>> const& subsets, subgraph_batch_config config = {}) { // classify the subgraph of host induced by each subset, results in the order of the subsets
+																																						  // workers take subsets off a shared counter, so uneven subsets balance themselves; each worker holds one host-sized workspace for the whole batch
+	std::vector<subgraph_result> results(subsets.size());
+	if (config.threads <= 0) config.threads = std::max(1, (int)(std::thread::hardware_concurrency()));
+	config.threads = (int)(std::min((size_t)(config.threads), std::max(subsets.size(), (size_t)(1))));
+
+	std::atomic<size_t> next{0};
+	auto work = [&] {
+		subgraph_workspace workspace{host};
+		std::vector<int> stack;
+		std::vector<char> seen;
+
+		for (size_t i = next++; i < subsets.size(); i = next++) {
+			results[i] = classify_subgraph(workspace, subsets[i], config, stack, seen);
+		}
+	};
+
+	if (config.threads == 1) { // no point starting a thread just to wait for it
+		work();
+		return results;
+	}
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < config.threads; t++) threads.emplace_back(work);
+	for (std::thread& t : threads) t.join();
+
+	return results;
+}
+
+#endif
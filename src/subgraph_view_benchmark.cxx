@@ -0,0 +1,161 @@
+// this classifies many neighbourhoods of one large host graph, once by copying each induced subgraph into a fresh graph and once through subgraph_views, and then through classify_subgraphs on every hardware thread
+// the host is a random GSP graph with a few random chords, so some neighbourhoods are GSP and some aren't; a neighbourhood is the first k vertices reached by a BFS from a random centre
+// optional command line argument: the order of the host graph (default 1000000)
+
+#include "gsp-sp-op.hxx"
+#include "subgraph-batch.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+graph random_host(int n, int max_degree, int chords, unsigned seed) { // grow a random GSP graph on n >= 2 vertices by subdividing an edge, adding a path of length 2 parallel to an edge, or hanging a new vertex off of one, then add some random chords
+																	   // the last two raise the degree of an endpoint, so they fall back to subdividing once it has max_degree
+	std::mt19937 rng{seed};
+	std::vector<edge_t> edges{{0, 1}};
+	std::vector<int> degree((size_t)(n), 0);
+	degree[0] = degree[1] = 1;
+
+	for (int w = 2; w < n; w++) {
+		edge_t& e = edges[rng() % edges.size()];
+		int op = (int)(rng() % 3);
+		if (op == 1 && degree[e.second] >= max_degree) op = 0;
+		if (op != 0 && degree[e.first] >= max_degree) op = 0;
+		degree[w] = (op == 2 ? 1 : 2);
+		if (op != 0) degree[e.first]++;
+		if (op == 1) degree[e.second]++;
+
+		if (op == 0) {
+			int v = e.second;
+			e.second = w;
+			edges.emplace_back(w, v);
+		} else if (op == 1) {
+			int u = e.first, v = e.second;
+			edges.emplace_back(u, w);
+			edges.emplace_back(w, v);
+		} else {
+			edges.emplace_back(e.first, w);
+		}
+	}
+
+	std::vector<int> label((size_t)(n));
+	std::iota(label.begin(), label.end(), 0);
+	std::shuffle(label.begin(), label.end(), rng);
+
+	graph g{n, (int)(edges.size()), std::vector<std::vector<int>>((size_t)(n))};
+	for (edge_t e : edges) g.add_edge(label[e.first], label[e.second]);
+	for (int i = 0; i < chords; i++) { // chords between vertices a few steps apart, so they land inside neighbourhoods
+		int u = (int)(rng() % n), v = u;
+		for (int step = 0; step < 3; step++) v = g.adjLists[v][rng() % g.adjLists[v].size()];
+		if (u != v && !g.adjacent(u, v)) {
+			g.add_edge(u, v);
+			g.e++;
+		}
+	}
+	return g;
+}
+
+std::vector<int> neighbourhood(graph const& g, int centre, int k, std::vector<char>& seen) { // the first k vertices a BFS from centre reaches (fewer if its component is smaller), which always induce a connected subgraph
+	std::vector<int> out{centre};
+	seen[centre] = true;
+	for (size_t i = 0; i < out.size() && (int)(out.size()) < k; i++) {
+		for (int u : g.adjLists[out[i]]) {
+			if (!seen[u] && (int)(out.size()) < k) {
+				seen[u] = true;
+				out.push_back(u);
+			}
+		}
+	}
+
+	for (int v : out) seen[v] = false;
+	return out;
+}
+
+graph copy_induced(graph const& host, std::vector<int> const& subset, std::vector<int>& local) { // the baseline: build the induced subgraph as a graph of its own, using a host-sized table (all -1) to translate vertex numbers
+	for (int i = 0; i < (int)(subset.size()); i++) local[subset[i]] = i;
+
+	graph g{(int)(subset.size()), 0, std::vector<std::vector<int>>(subset.size())};
+	for (int i = 0; i < g.n; i++) {
+		for (int u : host.adjLists[subset[i]]) {
+			if (local[u] != -1) g.adjLists[i].push_back(local[u]);
+		}
+		g.e += (int)(g.adjLists[i].size());
+	}
+	g.e /= 2;
+
+	for (int h : subset) local[h] = -1;
+	return g;
+}
+
+bool run(graph const& host, int threads) { // time every way of classifying neighbourhoods of host, returning whether they all agreed
+	int n = host.n;
+	bool ok = true;
+	std::mt19937 rng{11};
+	std::vector<char> seen((size_t)(n), false);
+	int hub = 0;
+	for (int v = 0; v < n; v++) hub = std::max(hub, host.degree(v));
+	std::cout << "====== host graph with " << host.n << " vertices, " << host.e << " edges, and maximum degree " << hub << " ======\n";
+
+	for (int k : {30, 300, 3000, 30000}) {
+		int count = std::max(1, 4 * n / k); // about four host vertices' worth of subsets per host vertex
+		std::vector<std::vector<int>> subsets;
+		for (int i = 0; i < count; i++) subsets.push_back(neighbourhood(host, (int)(rng() % n), k, seen));
+
+		std::vector<int> local((size_t)(n), -1);
+		std::vector<char> copied((size_t)(count));
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; i++) {
+			graph g = copy_induced(host, subsets[i], local);
+			copied[i] = GSP_SP_OP(g).is_gsp;
+		}
+		double copy_time = seconds_since(start);
+
+		subgraph_workspace workspace{host};
+		std::vector<char> viewed((size_t)(count));
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; i++) {
+			subgraph_view view;
+			workspace.bind(subsets[i], view);
+			viewed[i] = GSP_SP_OP(view).is_gsp;
+		}
+		workspace.unbind();
+		double view_time = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		std::vector<subgraph_result> batch = classify_subgraphs(host, subsets, subgraph_batch_config{threads, false, false});
+		double batch_time = seconds_since(start);
+
+		int gsp = 0;
+		for (int i = 0; i < count; i++) {
+			gsp += viewed[i];
+			if (copied[i] != viewed[i] || !batch[i].classified || batch[i].is_gsp != (bool)(viewed[i])) ok = false;
+		}
+
+		std::vector<std::vector<int>> sample(subsets.begin(), subsets.begin() + std::min(count, 20)); // authenticate a few against their views too
+		for (subgraph_result const& r : classify_subgraphs(host, sample, subgraph_batch_config{1, true, false})) ok = ok && r.authenticated;
+
+		std::cout << std::setw(6) << count << " neighbourhoods of " << std::setw(5) << k << " vertices (" << std::setprecision(1) << 100.0 * gsp / count << "% GSP): " << std::setprecision(3)
+				  << "copying " << copy_time << "s, views " << view_time << "s (" << std::setprecision(2) << copy_time / view_time << "x), batch " << std::setprecision(3) << batch_time << "s\n";
+	}
+
+	return ok;
+}
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	int threads = std::max(1, (int)(std::thread::hardware_concurrency()));
+	bool ok = true;
+
+	std::cout << "batches run on " << threads << " thread" << (threads == 1 ? "" : "s") << "\n" << std::fixed;
+	ok = run(random_host(n, 8, n / 50, 7), threads) && ok; // a host with bounded degrees, where the boundary of a neighbourhood is cheap to filter out
+	ok = run(random_host(n, n, n / 50, 7), threads) && ok;	// and one with hubs, whose long adjacency lists views have to skip through
+
+	if (!ok) std::cout << "the views disagreed with the copies, or failed to authenticate\n";
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// this times GSP_SP_OP on large graphs that produce a T4, i.e. graphs whose bicomps form a chain where the fake edge between a middle bicomp's cut vertices completes a K4
+// each T4 graph is timed against a control graph of the same order and size that is SP, so the difference is the cost of the aborted pass and its rollback
+// optional command line argument: the total order of the largest graphs (default 2000000)
+
+#include "gsp-sp-op.hxx"
+#include "workload-generators.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+graph t4_chain(int cycle, int rung, bool t4, unsigned seed) { // a chain of three bicomps: a cycle through c0, a middle bicomp on c0 and c1, and a cycle through c1
+															  // the middle bicomp is the cycle c0 - a - c1 - b - c0 with paths of length rung, plus one more path of length rung, from a to b if t4 (so the fake edge c0 c1 completes a K4) or from a to c1 otherwise (so everything stays SP)
+	graph_builder b;
+	int c0 = b.vertex(), c1 = b.vertex(), x = b.vertex(), y = b.vertex();
+
+	b.path(c0, c0, cycle);
+	b.path(c1, c1, cycle);
+	b.path(c0, x, rung);
+	b.path(x, c1, rung);
+	b.path(c1, y, rung);
+	b.path(y, c0, rung);
+	b.path(x, t4 ? y : c1, rung);
+
+	return b.build(seed);
+}
+
+int main(int argc, char ** argv) {
+	int big = argc > 1 ? std::atoi(argv[1]) : 2000000;
+	bool failed = false;
+
+	std::cout << std::fixed << std::setprecision(6);
+	for (int total : {big / 100, big / 10, big}) {
+		std::cout << "====== " << total << " VERTICES ======\n";
+		GSP_SP_OP(t4_chain(total / 2, 5, false, 0)); // untimed warm-up, so the first timed run doesn't also pay for growing the heap
+		for (int rung : {5, total / 40, total / 5}) { // a small T4 bicomp between two huge cycles, a medium one, and one giant bicomp holding almost the whole graph
+			int cycle = std::max(3, (total - 5 * rung) / 2);
+			double times[2];
+
+			for (bool t4 : {false, true}) {
+				graph g = t4_chain(cycle, rung, t4, (unsigned)(total + rung));
+				auto start = std::chrono::steady_clock::now();
+				gsp_sp_op_result r = GSP_SP_OP(g);
+				times[t4] = seconds_since(start);
+
+				if (!r.is_gsp || r.is_sp == t4 || !r.authenticate(g)) {
+					std::cout << (t4 ? "T4" : "control") << " graph with rungs of length " << rung << " was misclassified\n";
+					failed = true;
+				}
+			}
+
+			std::cout << "T4 bicomp with " << std::setw(8) << 5 * rung - 1 << " vertices: control " << times[0] << "s, T4 " << times[1] << "s (" << std::setprecision(2) << times[1] / times[0] << "x)\n" << std::setprecision(6);
+		}
+	}
+
+	return failed ? 1 : 0;
+}
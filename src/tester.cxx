@@ -1,6 +1,8 @@
 #include "gsp-sp-op.hxx"
 #include "GraphGenerator.hxx"
-#include "sp_validation_tests.hxx"
+#include "corpus-pipeline.hxx"
+#include "graph-normalization.hxx"
+#include "invariance-trials.hxx"
 #include "sp_visualization.hxx"
 #include <fstream>
 #include <iostream>
@@ -9,31 +11,25 @@
 #include <random>
 #include <numeric>
 #include <iomanip>
-void recompute_edge_count(graph& g) {
-    int count = 0;
-    for (int u = 0; u < g.n; ++u) {
-        for (int v : g.adjLists[u]) {
-            if (u < v) ++count; 
+#include <sstream>
+#include <set>
+// the invariance tests run on permuted views of the graph instead of permuted copies (see invariance-trials.hxx), comparing canonical summaries of the results with the summary of the result on g itself, which test_certificate_authentication authenticates
+bool check_invariance_trials(const std::vector<trial_outcome>& outcomes, const std::vector<invariance_trial>& trials, std::ostream& out) {
+    for (size_t t = 0; t < outcomes.size(); ++t) {
+        std::string what = trials[t].root >= 0 ? "root candidate " + std::to_string(trials[t].root) : std::string{trials[t].relabel ? "vertex relabeling" : "edge reordering"} + " (trial " + std::to_string(t / 2) + ")";
+        if (!outcomes[t].classified) {
+            out << "FAILED - Exception after " << what << ": " << outcomes[t].error << "\n";
+            return false;
         }
-    }
-    g.e = count;
-}
-graph create_permuted_graph_copy(const graph& g, const std::vector<int>& perm) {
-    graph g_permuted;
-    g_permuted.n = g.n;
-    g_permuted.adjLists.resize(g.n);
-    for (int u = 0; u < g.n; ++u) {
-        for (int v : g.adjLists[u]) {
-            if (u < v) {
-                g_permuted.add_edge(perm[u], perm[v]);
-            }
+        if (!outcomes[t].agrees) {
+            out << "FAILED - Different results after " << what << "\n";
+            return false;
         }
     }
-    recompute_edge_count(g_permuted);
-    return g_permuted;
+    return true;
 }
-bool test_certificate_authentication(const graph& g) {
-    std::cout << "  Testing certificate authentication... ";
+bool test_certificate_authentication(const graph& g, std::ostream& out = std::cout) {
+    out << "  Testing certificate authentication... ";
     gsp_sp_op_result result = GSP_SP_OP(g);
     bool auth_success = false;
     try {
@@ -46,140 +42,98 @@ bool test_certificate_authentication(const graph& g) {
         return false;
     }
     if (!auth_success) {
-        std::cout << "FAILED - Overall authentication failed\n";
+        out << "FAILED - Overall authentication failed\n";
         return false;
     }
     try {
         if (result.gsp_reason && !result.gsp_reason->authenticate(g)) {
-            std::cout << "FAILED - GSP certificate authentication failed\n";
+            out << "FAILED - GSP certificate authentication failed\n";
             return false;
         }
         if (result.sp_reason && !result.sp_reason->authenticate(g)) {
-            std::cout << "FAILED - SP certificate authentication failed\n";
+            out << "FAILED - SP certificate authentication failed\n";
             return false;
         }
         if (result.op_reason && !result.op_reason->authenticate(g)) {
-            std::cout << "FAILED - OP certificate authentication failed\n";
+            out << "FAILED - OP certificate authentication failed\n";
             return false;
         }
     } catch (...) {
-        std::cout << "FAILED - Individual certificate authentication threw exception\n";
+        out << "FAILED - Individual certificate authentication threw exception\n";
         return false;
     }
-    std::cout << "PASSED\n";
+    out << "PASSED\n";
     return true;
 }
-bool test_labeling_and_ordering_invariance(const graph& g) {
-    std::cout << "  Testing labeling and edge ordering invariance... ";
-    gsp_sp_op_result orig_result = GSP_SP_OP(g);
+bool test_labeling_and_ordering_invariance(const graph& g, std::ostream& out = std::cout, int threads = 0) {
+    out << "  Testing labeling and edge ordering invariance... ";
+    result_summary expected = summarize_result(GSP_SP_OP(g));
+    std::random_device rd;
+    std::vector<invariance_trial> trials;
     for (int trial = 0; trial < 3; ++trial) {
-        std::vector<int> perm(g.n);
-        std::iota(perm.begin(), perm.end(), 0);
-        std::random_device rd;
-        std::mt19937 rng(rd());
-        std::shuffle(perm.begin(), perm.end(), rng);
-        graph g_permuted = create_permuted_graph_copy(g, perm);
-        gsp_sp_op_result r_permuted = GSP_SP_OP(g_permuted);
-        if (r_permuted.is_gsp != orig_result.is_gsp ||
-            r_permuted.is_sp != orig_result.is_sp ||
-            r_permuted.is_op != orig_result.is_op) {
-            std::cout << "FAILED - Different results after vertex relabeling (trial " << trial << ")\n";
-            return false;
-        }
-        if (!r_permuted.authenticate(g_permuted)) {
-            std::cout << "FAILED - Certificate authentication failed after relabeling (trial " << trial << ")\n";
-            return false;
-        }
-        graph g_shuffled = g_permuted; 
-        for (auto& adj : g_shuffled.adjLists) {
-            std::shuffle(adj.begin(), adj.end(), rng);
-        }
-        gsp_sp_op_result r_shuffled = GSP_SP_OP(g_shuffled);
-        if (r_shuffled.is_gsp != orig_result.is_gsp ||
-            r_shuffled.is_sp != orig_result.is_sp ||
-            r_shuffled.is_op != orig_result.is_op) {
-            std::cout << "FAILED - Different results after edge reordering (trial " << trial << ")\n";
-            return false;
-        }
-        if (!r_shuffled.authenticate(g_shuffled)) {
-            std::cout << "FAILED - Certificate authentication failed after edge reordering (trial " << trial << ")\n";
-            return false;
-        }
+        unsigned seed = rd();
+        trials.push_back({true, false, -1, seed});
+        trials.push_back({true, true, -1, seed}); // the same numbering, with the adjacency lists scrambled on top of it
     }
-    std::cout << "PASSED\n";
+    if (!check_invariance_trials(run_invariance_trials(g, expected, trials, {threads}), trials, out)) return false;
+    out << "PASSED\n";
     return true;
 }
-bool test_multiple_root_and_validation(const graph& g) {
-    std::cout << "  Testing multiple root invariance and adjacency validation... ";
+bool test_multiple_root_and_validation(const graph& g, std::ostream& out = std::cout, int threads = 0) {
+    out << "  Testing multiple root invariance and adjacency validation... ";
     for (int u = 0; u < g.n; ++u) {
         std::set<int> neighbors; 
         for (int v : g.adjLists[u]) {
             if (v < 0 || v >= g.n) {
-                std::cout << "FAILED - Invalid vertex index " << v << " in adjacency list of " << u << "\n";
+                out << "FAILED - Invalid vertex index " << v << " in adjacency list of " << u << "\n";
                 return false;
             }
             if (u == v) {
-                std::cout << "FAILED - Self-loop detected at vertex " << u << "\n";
+                out << "FAILED - Self-loop detected at vertex " << u << "\n";
                 return false;
             }
             if (neighbors.count(v)) {
-                std::cout << "FAILED - Multi-edge detected: " << u << " appears multiple times in adjacency list of " << v << "\n";
+                out << "FAILED - Multi-edge detected: " << u << " appears multiple times in adjacency list of " << v << "\n";
                 return false;
             }
             neighbors.insert(v);
             bool reciprocal = std::find(g.adjLists[v].begin(), g.adjLists[v].end(), u) != g.adjLists[v].end();
             if (!reciprocal) {
-                std::cout << "FAILED - Missing reciprocal edge for " << u << " <-> " << v << "\n";
+                out << "FAILED - Missing reciprocal edge for " << u << " <-> " << v << "\n";
                 return false;
             }
         }
     }
-    gsp_sp_op_result orig_result = GSP_SP_OP(g);
-    for (int root_candidate = 0; root_candidate < std::min(g.n, 5); ++root_candidate) {
-        std::vector<int> perm(g.n);
-        std::iota(perm.begin(), perm.end(), 0);
-        std::swap(perm[0], perm[root_candidate]);
-        std::random_device rd;
-        std::mt19937 rng(rd());
-        std::shuffle(perm.begin() + 1, perm.end(), rng);
-        graph g_reordered = create_permuted_graph_copy(g, perm);
-        gsp_sp_op_result r = GSP_SP_OP(g_reordered);
-        if (r.is_gsp != orig_result.is_gsp ||
-            r.is_sp != orig_result.is_sp ||
-            r.is_op != orig_result.is_op) {
-            std::cout << "FAILED - Different results with root candidate " << root_candidate << "\n";
-            return false;
-        }
-        if (!r.authenticate(g_reordered)) {
-            std::cout << "FAILED - Authentication failed with root candidate " << root_candidate << "\n";
-            return false;
-        }
-    }
-    std::cout << "PASSED\n";
+    result_summary expected = summarize_result(GSP_SP_OP(g));
+    std::random_device rd;
+    std::vector<invariance_trial> trials;
+    for (int root_candidate = 0; root_candidate < std::min(g.n, 5); ++root_candidate) trials.push_back({true, false, root_candidate, rd()});
+    if (!check_invariance_trials(run_invariance_trials(g, expected, trials, {threads}), trials, out)) return false;
+    out << "PASSED\n";
     return true;
 }
-bool test_and_create_visualization(const graph& g, const std::string& test_name) {
-    std::cout << "  Creating visualization... ";
+bool test_and_create_visualization(const graph& g, const std::string& test_name, std::ostream& out = std::cout) {
+    out << "  Creating visualization... ";
     if (g.n > 50) {
-        std::cout << "SKIPPED (graph too large: " << g.n << " vertices)\n";
+        out << "SKIPPED (graph too large: " << g.n << " vertices)\n";
         return true;
     }
     try {
         gsp_sp_op_result result = GSP_SP_OP(g);
         if (!result.authenticate(g)) {
-            std::cout << "FAILED - Result authentication failed\n";
+            out << "FAILED - Result authentication failed\n";
             return false;
         }
         std::filesystem::create_directories("visualization_output");
         std::string base_filename = "visualization_output/" + test_name;
         create_complete_sp_visualization(g, result, base_filename);
-        std::cout << "COMPLETED (files saved to visualization_output/)\n";
+        out << "COMPLETED (files saved to visualization_output/)\n";
         return true;
     } catch (const std::exception& e) {
-        std::cout << "FAILED - Exception during visualization: " << e.what() << "\n";
+        out << "FAILED - Exception during visualization: " << e.what() << "\n";
         return false;
     } catch (...) {
-        std::cout << "FAILED - Unknown exception during visualization\n";
+        out << "FAILED - Unknown exception during visualization\n";
         return false;
     }
 }
@@ -201,7 +155,7 @@ void test_random_graphs() {
         try {
             long seed = static_cast<long>(std::time(nullptr)) + static_cast<long>(i * 12345);
             graph g = generate_graph(params.nC, params.lC, params.nK, params.lK, params.three_edges, seed);
-            recompute_edge_count(g);
+            normalize_graph(g);
             std::cout << "Generated graph: n=" << g.n << ", e=" << g.e << std::endl;
             bool all_passed = true;
             all_passed &= test_certificate_authentication(g);
@@ -236,42 +190,57 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     std::cout << "Testing graphs from directory: " << dir << "\n\n";
-    int total_tests = 0;
+    // reading, parsing, classification and drawing run as separate parallel stages (see corpus-pipeline.hxx); each file's test output is buffered and printed in sorted file order
+    std::vector<std::filesystem::path> files = list_corpus_files(dir);
+    std::vector<char> tests_passed(files.size(), false);
+    std::vector<char> viz_passed(files.size(), false);
+    std::vector<std::string> viz_logs(files.size());
+    int total_tests = (int)files.size();
     int passed_tests = 0;
-    for (auto file : std::filesystem::directory_iterator{dir}) {
-        if (file.path().extension() == ".txt") {
-            std::string filename = file.path().filename().string();
-            std::cout << "\n======= Testing File: " << filename << " =======\n";
-            total_tests++;
-            std::fstream fin{file.path()};
-            if (!fin.is_open()) {
-                std::cout << "Error: Cannot open file " << file.path() << "\n";
-                continue;
+
+    corpus_pipeline_report stats = run_corpus_pipeline(files, corpus_pipeline_config{},
+        [&](corpus_item& item) {
+            std::ostringstream out;
+            out << "Graph loaded: n=" << item.g.n << ", e=" << item.g.e << std::endl;
+            if (!item.normalization.simple()) {
+                out << "  Normalized input: ";
+                item.normalization.print(out);
             }
-            graph g;
-            try {
-                fin >> g;
-                recompute_edge_count(g);
-            } catch (...) {
-                std::cout << "Error: Failed to read graph from file\n";
-                continue;
-            }
-            std::cout << "Graph loaded: n=" << g.n << ", e=" << g.e << std::endl;
             bool all_tests_passed = true;
-            all_tests_passed &= test_certificate_authentication(g);
-            all_tests_passed &= test_labeling_and_ordering_invariance(g);
-            all_tests_passed &= test_multiple_root_and_validation(g);
-            std::string clean_filename = filename;
-            std::replace(clean_filename.begin(), clean_filename.end(), '.', '_');
-            all_tests_passed &= test_and_create_visualization(g, clean_filename);
-            if (all_tests_passed) {
-                passed_tests++;
-                std::cout << "*** ALL TESTS PASSED for " << filename << " ***\n";
-            } else {
-                std::cout << "*** SOME TESTS FAILED for " << filename << " ***\n";
+            all_tests_passed &= test_certificate_authentication(item.g, out);
+            all_tests_passed &= test_labeling_and_ordering_invariance(item.g, out, 1); // the pipeline already runs a classifier thread per core
+            all_tests_passed &= test_multiple_root_and_validation(item.g, out, 1);
+            tests_passed[item.index] = all_tests_passed;
+            item.report = out.str();
+        },
+        [&](corpus_item& item) {
+            std::cout << "\n======= Testing File: " << item.path.filename().string() << " =======\n";
+            if (!item.loaded) {
+                std::cout << "Error: " << item.error << " (" << item.path << ")\n";
+                return;
             }
+            std::cout << item.report;
+        },
+        [&](corpus_item& item) {
+            std::string clean_filename = item.path.filename().string();
+            std::replace(clean_filename.begin(), clean_filename.end(), '.', '_');
+            std::ostringstream out;
+            viz_passed[item.index] = test_and_create_visualization(item.g, clean_filename, out);
+            viz_logs[item.index] = out.str();
+        });
+
+    for (size_t i = 0; i < files.size(); i++) {
+        std::string filename = files[i].filename().string();
+        if (!viz_logs[i].empty()) std::cout << "\n" << filename << ":" << viz_logs[i];
+        if (tests_passed[i] && viz_passed[i]) {
+            passed_tests++;
+            std::cout << "*** ALL TESTS PASSED for " << filename << " ***\n";
+        } else {
+            std::cout << "*** SOME TESTS FAILED for " << filename << " ***\n";
         }
     }
+    std::cout << "\n";
+    stats.print(std::cout);
     std::cout << "\n=== File Testing Summary ===\n";
     std::cout << "Total files tested: " << total_tests << std::endl;
     std::cout << "Files passed all tests: " << passed_tests << std::endl;
@@ -0,0 +1,230 @@
+// this file contains seedable generators for the shapes of graph the benchmarks run on, all of which take linear time
+// generate_graph (see GraphGenerator.hxx) only produces biconnected graphs, so it never exercises the handling of cut vertices, chains of bicomps, dangling compositions or fake edges; block_tree, block_chain, hub_graph and path_graph do
+// planted_obstruction hides a K4, K23 or T4 at a chosen depth below the DFS root, to measure how early the implementation can stop, and with_chords adds random short chords to any graph, which scatters obstructions over it
+// every generator shuffles the vertex numbers (so the DFS jumps all over memory) with the same seed it builds the graph with, so the same arguments always give the same graph
+
+#ifndef __WORKLOAD_GENERATORS_HXX__
+#define __WORKLOAD_GENERATORS_HXX__
+
+#include "graph.hxx"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+struct graph_builder { // collects edges and hands out fresh vertex numbers, then shuffles the labels when building the graph
+	int n = 0;
+	std::vector<edge_t> edges;
+
+	int vertex() {return n++;}
+
+	void edge(int u, int v) {edges.emplace_back(u, v);}
+
+	void path(int s, int t, int length) { // add a path of the given length (at least 1) from s to t through fresh vertices
+		int prev = s;
+		for (int i = 1; i < length; i++) {
+			int next = vertex();
+			edges.emplace_back(prev, next);
+			prev = next;
+		}
+		edges.emplace_back(prev, t);
+	}
+
+	int block(int s, int size, std::mt19937& rng) { // add a random biconnected SP block on s and size - 1 fresh vertices (just an edge, i.e. a bridge, if size is 2), returning the first fresh vertex
+													 // the block starts as a triangle, which stays biconnected while edges are subdivided or get a path of length 2 in parallel
+		int first = vertex();
+		if (size <= 2) {
+			edge(s, first);
+			return first;
+		}
+
+		size_t begin = edges.size();
+		int w = vertex();
+		edge(s, first);
+		edge(first, w);
+		edge(w, s);
+		for (int i = 3; i < size; i++) {
+			w = vertex();
+			edge_t& e = edges[begin + rng() % (edges.size() - begin)];
+			if (rng() % 2 == 0) {
+				int v = e.second;
+				e.second = w;
+				edges.emplace_back(w, v);
+			} else {
+				int u = e.first, v = e.second;
+				edges.emplace_back(u, w);
+				edges.emplace_back(w, v);
+			}
+		}
+		return first;
+	}
+
+	graph build(unsigned seed, bool keep_root = false) { // shuffle the labels, keeping vertex 0 as 0 if keep_root (the implementation's DFS starts there)
+		std::mt19937 rng{seed};
+		std::vector<int> label((size_t)(n));
+		std::iota(label.begin(), label.end(), 0);
+		std::shuffle(label.begin() + (keep_root && n > 0 ? 1 : 0), label.end(), rng);
+
+		graph g{n, (int)(edges.size()), std::vector<std::vector<int>>((size_t)(n))};
+		for (edge_t e : edges) g.add_edge(label[e.first], label[e.second]);
+		return g;
+	}
+};
+
+graph random_gsp_graph(int n, unsigned seed, bool dangling = true) { // grow a random simple GSP graph on n >= 2 vertices by repeatedly subdividing an edge, adding a path of length 2 parallel to an edge, or (if dangling) hanging a new vertex off of one
+	std::mt19937 rng{seed};
+	std::vector<edge_t> edges{{0, 1}};
+
+	for (int w = 2; w < n; w++) {
+		edge_t& e = edges[rng() % edges.size()];
+		int op = (int)(rng() % (dangling ? 3 : 2));
+		if (op == 0) {
+			int v = e.second;
+			e.second = w;
+			edges.emplace_back(w, v);
+		} else if (op == 1) {
+			int u = e.first, v = e.second;
+			edges.emplace_back(u, w);
+			edges.emplace_back(w, v);
+		} else {
+			edges.emplace_back(e.first, w);
+		}
+	}
+
+	std::vector<int> label((size_t)(n));
+	std::iota(label.begin(), label.end(), 0);
+	std::shuffle(label.begin(), label.end(), rng);
+
+	graph g{n, (int)(edges.size()), std::vector<std::vector<int>>((size_t)(n))};
+	for (edge_t e : edges) g.add_edge(label[e.first], label[e.second]);
+	return g;
+}
+
+graph random_outerplanar_graph(int n, unsigned seed) { // grow a random outerplanar graph on n >= 2 vertices by putting a triangle or a quadrilateral on an edge of the outer face or hanging a new vertex off of one end of it
+	std::mt19937 rng{seed};
+	std::vector<edge_t> edges{{0, 1}};
+	std::vector<edge_t> outer{{0, 1}}; // edges on the outer face (bridges only once)
+	for (int w = 2; w < n; w++) {
+		size_t i = rng() % outer.size();
+		int u = outer[i].first, v = outer[i].second;
+		int op = (int)(rng() % 3);
+		if (op == 1 && w + 1 < n) { // quadrilateral u, w, w + 1, v
+			edges.emplace_back(u, w);
+			edges.emplace_back(w, w + 1);
+			edges.emplace_back(w + 1, v);
+			outer[i] = {u, w};
+			outer.emplace_back(w, w + 1);
+			outer.emplace_back(w + 1, v);
+			w++;
+		} else if (op == 2) {
+			edges.emplace_back(u, w);
+			outer.emplace_back(u, w);
+		} else { // triangle u, w, v
+			edges.emplace_back(u, w);
+			edges.emplace_back(w, v);
+			outer[i] = {u, w};
+			outer.emplace_back(w, v);
+		}
+	}
+
+	std::vector<int> label((size_t)(n));
+	std::iota(label.begin(), label.end(), 0);
+	std::shuffle(label.begin(), label.end(), rng);
+
+	graph g{n, (int)(edges.size()), std::vector<std::vector<int>>((size_t)(n))};
+	for (edge_t e : edges) g.add_edge(label[e.first], label[e.second]);
+	return g;
+}
+
+graph block_tree(int blocks, int min_size, int max_size, unsigned seed) { // a tree of random SP blocks (see graph_builder::block) with between min_size and max_size vertices each (2 is a bridge), each hung off of a random vertex of the ones before it
+	std::mt19937 rng{seed};
+	graph_builder b;
+	b.vertex();
+	for (int i = 0; i < blocks; i++) {
+		int size = min_size + (int)(rng() % (unsigned)(max_size - min_size + 1));
+		b.block((int)(rng() % (unsigned)(b.n)), size, rng);
+	}
+	return b.build(seed);
+}
+
+graph block_chain(int blocks, int min_size, int max_size, unsigned seed) { // random SP blocks like block_tree, but each one hung off of a vertex of the one before other than the one that one is hung off of, so the bicomps form a chain (and the DFS from the end of it goes through each in turn)
+	std::mt19937 rng{seed};
+	graph_builder b;
+	int cut = b.vertex();
+	for (int i = 0; i < blocks; i++) {
+		int size = min_size + (int)(rng() % (unsigned)(max_size - min_size + 1));
+		int first = b.block(cut, size, rng);
+		cut = first + (int)(rng() % (unsigned)(b.n - first)); // any vertex of the new block but the old cut vertex
+	}
+	return b.build(seed, true);
+}
+
+graph hub_graph(int n, int hubs, bool fans, unsigned seed) { // hubs joined in a path, with every other vertex hung off of a random hub, so hubs = 1 is a star
+															 // with fans, every vertex is also joined to the last one hung off of the same hub, so each hub is the centre of a fan (one big biconnected, outerplanar block) instead of a cut vertex with a dangling edge per neighbour
+	std::mt19937 rng{seed};
+	graph_builder b;
+	hubs = std::max(1, std::min(hubs, n));
+	std::vector<int> last((size_t)(hubs), -1);
+	for (int h = 0; h < hubs; h++) {
+		b.vertex();
+		if (h > 0) b.edge(h - 1, h);
+	}
+	for (int w = hubs; w < n; w++) {
+		int h = (int)(rng() % (unsigned)(hubs));
+		b.edge(h, b.vertex());
+		if (fans && last[h] != -1) b.edge(last[h], w);
+		last[h] = w;
+	}
+	return b.build(seed);
+}
+
+graph path_graph(int n, bool cycle, unsigned seed) { // a path on n vertices starting at the DFS root, so the DFS goes n deep, closed into a cycle if cycle (which is one bicomp rather than n - 1)
+	graph_builder b;
+	b.vertex();
+	for (int w = 1; w < n; w++) b.edge(w - 1, b.vertex());
+	if (cycle && n >= 3) b.edge(n - 1, 0);
+	return b.build(seed, true);
+}
+
+enum class obstruction {K4, K23, T4};
+
+graph planted_obstruction(int n, obstruction kind, int depth, unsigned seed) { // a path of length depth down from the DFS root to a small obstruction, and a random SP block on the far side of it with the rest of the n vertices, so the bicomps form a chain
+																				// a K4 makes the graph neither GSP, SP nor OP; a K23 keeps it GSP and SP but not OP; a T4 (two cut vertices of a bicomp of the chain whose fake edge completes a K4, see t4_chain in t4_rollback_benchmark.cxx) keeps it GSP but not SP
+	std::mt19937 rng{seed};
+	graph_builder b;
+	int top = b.vertex();
+	for (int i = 0; i < depth; i++) {
+		int next = b.vertex();
+		b.edge(top, next);
+		top = next;
+	}
+
+	int bottom = b.vertex(); // the vertex the rest of the graph hangs off of
+	if (kind == obstruction::K4) { // top, bottom, x, y all adjacent
+		int x = b.vertex(), y = b.vertex();
+		for (edge_t e : {edge_t{top, bottom}, edge_t{top, x}, edge_t{top, y}, edge_t{bottom, x}, edge_t{bottom, y}, edge_t{x, y}}) b.edge(e.first, e.second);
+	} else if (kind == obstruction::K23) { // three paths of length 2 from top to bottom
+		for (int i = 0; i < 3; i++) b.path(top, bottom, 2);
+	} else { // the cycle top - x - bottom - y - top and the path x - y, whose fake edge top - bottom completes a K4
+		int x = b.vertex(), y = b.vertex();
+		for (edge_t e : {edge_t{top, x}, edge_t{x, bottom}, edge_t{bottom, y}, edge_t{y, top}, edge_t{x, y}}) b.edge(e.first, e.second);
+	}
+
+	if (b.n < n) b.block(bottom, n - b.n + 1, rng);
+	return b.build(seed, true);
+}
+
+graph with_chords(graph g, int chords, unsigned seed) { // add chords from random vertices to ones a random walk of 3 steps away, so they land inside bicomps (or join neighbouring ones); on top of any of the generators above, this makes K4s (and K23s) all over the graph
+	std::mt19937 rng{seed};
+	for (int i = 0; i < chords; i++) {
+		int u = (int)(rng() % (unsigned)(g.n)), v = u;
+		for (int step = 0; step < 3; step++) v = g.adjLists[v][rng() % g.adjLists[v].size()];
+		if (u != v && !g.adjacent(u, v)) {
+			g.add_edge(u, v);
+			g.e++;
+		}
+	}
+	return g;
+}
+
+#endif
@@ -0,0 +1,99 @@
+// this times GSP_SP_OP on every family of workload-generators.hxx at one size, so the handling of cut vertices, chains of bicomps, dangling compositions and early exits is measured alongside the biconnected graphs generate_graph makes
+// for every graph it reports the time to classify it (best of a few runs) and to authenticate the result, which certificates came out (and how many bicomps an OP certificate has); any graph classified other than its family promises is reported as a failure
+// the planted obstructions are swept over a few depths, so the cost of everything the implementation skips once it finds one shows up as the difference between them
+// optional command line arguments: the order of the graphs (default 1000000) and a seed (default 39)
+
+#include "gsp-sp-op.hxx"
+#include "GraphGenerator.hxx"
+#include "workload-generators.hxx"
+#include "benchmark-util.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+char const * certificate_name(std::shared_ptr<certificate> const& cert) {
+	if (std::dynamic_pointer_cast<negative_cert_K4>(cert)) return "K4";
+	if (std::dynamic_pointer_cast<negative_cert_K23>(cert)) return "K23";
+	if (std::dynamic_pointer_cast<negative_cert_T4>(cert)) return "T4";
+	if (std::dynamic_pointer_cast<negative_cert_tri_comp_cut>(cert)) return "tri-comp-cut";
+	if (std::dynamic_pointer_cast<negative_cert_tri_cut_comp>(cert)) return "tri-cut-comp";
+	if (std::dynamic_pointer_cast<positive_cert_gsp>(cert)) return "tree";
+	if (std::dynamic_pointer_cast<positive_cert_op>(cert)) return "boundary";
+	return "none";
+}
+
+struct workload {
+	std::string name;
+	std::function<graph()> make;
+	int known;	// the classes (1 GSP, 2 SP, 4 OP) the family decides, whatever the random choices
+	int expect; // which of those it's in
+};
+
+int main(int argc, char ** argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	unsigned seed = argc > 2 ? (unsigned)(std::atoi(argv[2])) : 39;
+
+	std::vector<workload> workloads = {
+		{"random GSP", [&] {return random_gsp_graph(n, seed);}, 1, 1},
+		{"outerplanar", [&] {return random_outerplanar_graph(n, seed);}, 1 | 4, 1 | 4},
+		{"generate_graph", [&] {return generate_graph(n / 10, 10, 0, 0, 1, seed);}, 0, 0},
+		{"block tree, bridges", [&] {return block_tree(n - 1, 2, 2, seed);}, 1 | 4, 1 | 4},
+		{"block tree, 3-10", [&] {return block_tree(n / 6, 3, 10, seed);}, 1, 1},
+		{"block tree, 1000", [&] {return block_tree(n / 1000, 1000, 1000, seed);}, 1, 1},
+		{"block chain, 3-10", [&] {return block_chain(n / 6, 3, 10, seed);}, 1, 1},
+		{"block chain, 1000", [&] {return block_chain(n / 1000, 1000, 1000, seed);}, 1, 1},
+		{"star", [&] {return hub_graph(n, 1, false, seed);}, 1 | 2 | 4, 1 | 4},
+		{"100 hubs", [&] {return hub_graph(n, 100, false, seed);}, 1 | 2 | 4, 1 | 4},
+		{"100 fans", [&] {return hub_graph(n, 100, true, seed);}, 1 | 4, 1 | 4},
+		{"path", [&] {return path_graph(n, false, seed);}, 1 | 2 | 4, 1 | 2 | 4},
+		{"cycle", [&] {return path_graph(n, true, seed);}, 1 | 2 | 4, 1 | 2 | 4},
+	};
+
+	for (int eighths : {1, 4, 7}) {
+		int depth = (int)((long long)(n) * eighths / 8);
+		std::string at = " at depth " + std::to_string(depth);
+		workloads.push_back({"K4" + at, [=] {return planted_obstruction(n, obstruction::K4, depth, seed);}, 1 | 2 | 4, 0});
+		workloads.push_back({"K23" + at, [=] {return planted_obstruction(n, obstruction::K23, depth, seed);}, 1 | 2 | 4, 1 | 2});
+		workloads.push_back({"T4" + at, [=] {return planted_obstruction(n, obstruction::T4, depth, seed);}, 1 | 2, 1});
+	}
+
+	bool failed = false;
+	std::cout << std::fixed << std::setprecision(3);
+	GSP_SP_OP(random_gsp_graph(n, seed)); // untimed warm-up, so the first timed run doesn't also pay for growing the heap
+
+	for (workload const& w : workloads) {
+		graph const g = w.make();
+
+		double best = 0;
+		gsp_sp_op_result r;
+		for (int pass = 0; pass < 3; pass++) {
+			auto start = std::chrono::steady_clock::now();
+			r = GSP_SP_OP(g);
+			double time = seconds_since(start);
+			if (pass == 0 || time < best) best = time;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		bool authentic = r.authenticate(g);
+		double authenticate_time = seconds_since(start);
+
+		int classes = (int)(r.is_gsp) | (int)(r.is_sp) << 1 | (int)(r.is_op) << 2;
+		auto op = std::dynamic_pointer_cast<positive_cert_op>(r.op_reason);
+		std::cout << std::left << std::setw(24) << w.name << std::right << std::setw(8) << g.n << " vertices " << std::setw(8) << g.e << " edges: classify " << best << "s, authenticate " << authenticate_time << "s, "
+				  << (r.is_gsp ? "GSP" : "-") << "/" << (r.is_sp ? "SP" : "-") << "/" << (r.is_op ? "OP" : "-") << " (" << certificate_name(r.gsp_reason) << ", " << certificate_name(r.sp_reason) << ", " << certificate_name(r.op_reason)
+				  << (op ? ", " + std::to_string(op->boundaries.size()) + " bicomps" : std::string{}) << ")\n";
+
+		if (!authentic || (classes & w.known) != w.expect) {
+			std::cout << "  " << (!authentic ? "the result did not authenticate" : "the graph was misclassified") << "\n";
+			failed = true;
+		}
+	}
+
+	return failed ? 1 : 0;
+}